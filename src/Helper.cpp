@@ -5,34 +5,63 @@
 #include "arguments/NetworkCreatorArguments.h"
 #include "arguments/NetworkTeacherArguments.h"
 #include "arguments/QLearningArguments.h"
+#include "arguments/NetworkEvaluatorArguments.h"
 #include "arguments/WebAppArguments.h"
+#include "arguments/LoadTestArguments.h"
 
 namespace nn2048
 {
 
 void Helper::showHelp() const
 {
-    std::cout << "Usage: " << _execName << " [mode] [mode arguments]" << std::endl << std::endl;
+    std::cout << "Usage: " << _execName << " [mode] [mode arguments]" << std::endl;
+    std::cout << "Every mode accepts " << Arguments::SeedArgument << " seed argument. Runs with the same seed draw the same random" << std::endl;
+    std::cout << "numbers. Seed is picked at random and printed when not specified." << std::endl;
+    std::cout << "Every mode also accepts " << Arguments::LogLevelArgument << " level argument (debug, info, warning, error)," << std::endl;
+    std::cout << "info by default. Debug lines are compiled out of release builds." << std::endl << std::endl;
 
     std::cout << "merge mode - merges replay memory files into one json used in training mode" << std::endl;
-    std::cout << "    " << ReplayMemoryMergerArguments::InputDirectoryArgument << " directory - input directory with replay memory json files" << std::endl;
-    std::cout << "    " << ReplayMemoryMergerArguments::OutputFileNameArgument << " file      - output replay memory file name" << std::endl << std::endl;
+    std::cout << "    Ingested files are listed in <output>.manifest. When the output and its manifest" << std::endl;
+    std::cout << "    exist, only new files are appended (not with deduplication, which rebuilds)." << std::endl;
+    std::cout << "    " << ReplayMemoryMergerArguments::InputDirectoryArgument << " directory - input directory with replay memory json files and games recorded" << std::endl;
+    std::cout << "                   by the webapp (.nnrz), files still being recorded end with .part and are skipped" << std::endl;
+    std::cout << "    " << ReplayMemoryMergerArguments::OutputFileNameArgument << " file      - output replay memory file name, .bin extension writes binary" << std::endl;
+    std::cout << "                   shard for streaming learn mode" << std::endl;
+    std::cout << "    " << ReplayMemoryMergerArguments::ThreadCountArgument    << " threads   - number of threads decoding input files (optional, all hardware" << std::endl;
+    std::cout << "                   threads by default)" << std::endl;
+    std::cout << "    " << ReplayMemoryMergerArguments::ShardCountArgument     << " count     - split output into count shard files named after the output, whole" << std::endl;
+    std::cout << "                   episodes are assigned by hash, <output>.index lists the shards" << std::endl;
+    std::cout << "    " << ReplayMemoryMergerArguments::DeduplicateArgument    << "           - aggregate identical board and action samples, each unique sample" << std::endl;
+    std::cout << "                   is written once as a single state episode rewarded with mean return" << std::endl;
+    std::cout << "    " << ReplayMemoryMergerArguments::ReduceSymmetriesArgument << "           - deduplicate boards equal up to rotation and reflection (requires " << ReplayMemoryMergerArguments::DeduplicateArgument << ")" << std::endl;
+    std::cout << "    " << ReplayMemoryMergerArguments::MaxSizeArgument        << " size - keep uniform sample of size states read in one pass, each is written" << std::endl;
+    std::cout << "                   as a single state episode rewarded with its return (optional)" << std::endl;
+    std::cout << "    " << ReplayMemoryMergerArguments::GammaFactorArgument    << " gamma     - gamma factor of deduplicated and sampled returns (optional, " << DefaultGammaFactor << " by default)" << std::endl << std::endl;
 
     std::cout << "create mode - creates new neural network with random weights" << std::endl;
     std::cout << "    " << NetworkCreatorArguments::NetworkStructureArgument   << " structure - network structure (eg. 2,3,4 - 2 inputs, 3 hidden" << std::endl;
     std::cout << "                   neurons, 4 outputs)" << std::endl;
     std::cout << "    " << NetworkCreatorArguments::NetworkFileNameArgument    << " output    - output file name" << std::endl;
     std::cout << "    " << NetworkCreatorArguments::WeightDistributionArgument << " distrib   - weight distribution amplitude (optional, " << DefaultWeightDistribution << " by default)" << std::endl;
-    std::cout << "    " << NetworkCreatorArguments::CreateFannNetworkArgument  << "           - creates FANN network instead of standard json one" << std::endl << std::endl;
+    std::cout << "    " << NetworkCreatorArguments::CreateFannNetworkArgument  << "           - creates FANN network instead of standard json one" << std::endl;
+    std::cout << "    " << NetworkCreatorArguments::CreateNTupleNetworkArgument << "           - creates n-tuple network (structure is not needed)" << std::endl << std::endl;
 
     std::cout << "learn mode - performs backpropagation algorythm" << std::endl;
     std::cout << "    " << NetworkTeacherArguments::NetworkFileNameArgument       << " file      - neural network file name" << std::endl;
     std::cout << "    " << NetworkTeacherArguments::ReplayMemoryDirectoryArgument << " dir       - directory containing replay memory jsons" << std::endl;
     std::cout << "    " << NetworkTeacherArguments::MaxEpochsArgument             << " epochs    - limit learning by maximum number of epochs" << std::endl;
-    std::cout << "    " << NetworkTeacherArguments::MinErrorArgument              << " error     - limit learning by minimum error value" << std::endl;
-    std::cout << "    " << NetworkTeacherArguments::LearningRateArgument          << " rate      - learning rate (optional, " << DefaultLearningRate << " by default)" << std::endl;
+    std::cout << "    " << NetworkTeacherArguments::MinErrorArgument              << " error     - stop learning when average epoch loss drops to this value" << std::endl;
+    std::cout << "    " << NetworkTeacherArguments::LearningRateArgument          << " rate      - learning rate (optional, " << DefaultLearningRate << " by default, " << DefaultAdamLearningRate << " with adam)" << std::endl;
     std::cout << "    " << NetworkTeacherArguments::MomentumFactorArgument        << " momentum  - momentum factor (optional, " << DefaultMomentumFactor << " by default)" << std::endl;
     std::cout << "    " << NetworkTeacherArguments::GammaFactorArgument           << " gamma     - gamma factor (optional, " << DefaultGammaFactor << " by default)" << std::endl;
+    std::cout << "    " << NetworkTeacherArguments::ThreadCountArgument     << " threads   - number of threads loading replay files and computing gradients" << std::endl;
+    std::cout << "                   (optional, all hardware threads by default)" << std::endl;
+    std::cout << "    " << NetworkTeacherArguments::StreamShardsArgument          << "           - use binary replay shards (.bin) from the directory instead of" << std::endl;
+    std::cout << "                   json files, they are streamed or mapped without loading" << std::endl;
+    std::cout << "    " << NetworkTeacherArguments::ShuffleBufferSizeArgument     << " size      - shuffle buffer size used when streaming (optional, " << DefaultShuffleBufferSize << " by default)" << std::endl;
+    std::cout << "    " << NetworkTeacherArguments::OptimizerArgument             << " name      - train with epoch level optimizer: rprop (full batch) or adam" << std::endl;
+    std::cout << "                   (minibatches)" << std::endl;
+    std::cout << "    " << NetworkTeacherArguments::BatchSizeArgument             << " size      - minibatch size of adam and of prefetched learn batches, 0 for full adam batch (optional, " << DefaultOptimizerBatchSize << " by default)" << std::endl;
     std::cout << "    Arguments " << NetworkTeacherArguments::MaxEpochsArgument << " and " << NetworkTeacherArguments::MinErrorArgument << " can be used in combination with each other. At least" << std::endl;
     std::cout << "    one of them has to be specified." << std::endl << std::endl;
 
@@ -46,16 +75,55 @@ void Helper::showHelp() const
     std::cout << "    " << QLearningArguments::EpsilonFactorArgument        << " epsilon   - epsilon factor (optional, " << DefaultEpsilonFactor << " by default)" << std::endl;
     std::cout << "    " << QLearningArguments::ReplayMemorySizeArgument     << " size      - replay memory size (optional, " << DefaultReplayMemorySize << " by default)" << std::endl;
     std::cout << "    " << QLearningArguments::ReplayBatchSizeArgument      << " size      - replay batch size (optional, " << DefaultReplayBatchSize << " by default)" << std::endl;
-    std::cout << "    " << QLearningArguments::ReplayMemoryFileNameArgument << " file      - json containing initial replay memory (optional)" << std::endl << std::endl;
+    std::cout << "    " << QLearningArguments::ReplayMemoryFileNameArgument << " file      - json or shard with initial replay memory (optional), a uniform" << std::endl;
+    std::cout << "                   sample is kept when it has more states than replay memory size" << std::endl;
+    std::cout << "    " << QLearningArguments::AfterstateLearningArgument   << "           - learn afterstate values with TD(0) instead of Q-values (FANN network" << std::endl;
+    std::cout << "                    with a single output, replay memory arguments are ignored)" << std::endl;
+    std::cout << "    When network file is an n-tuple network, afterstate values are learned with TD(0)" << std::endl;
+    std::cout << "    and replay memory arguments are ignored." << std::endl << std::endl;
+
+    std::cout << "evaluate mode - plays games with expectimax search using neural network as board evaluator" << std::endl;
+    std::cout << "    " << NetworkEvaluatorArguments::NetworkFileNameArgument      << " file      - neural network file name (n-tuple networks are detected automatically)" << std::endl;
+    std::cout << "    " << NetworkEvaluatorArguments::FannNetworkArgument          << "           - network is a FANN network instead of standard json one" << std::endl;
+    std::cout << "    " << NetworkEvaluatorArguments::GameCountArgument            << " count     - number of games to play (optional, " << DefaultEvaluationGameCount << " by default)" << std::endl;
+    std::cout << "    " << NetworkEvaluatorArguments::SearchDepthArgument          << " depth     - search depth in tile spawns, 0 plays greedily (optional, " << DefaultSearchDepth << " by default)" << std::endl;
+    std::cout << "    " << NetworkEvaluatorArguments::ProbabilityThresholdArgument << " prob      - chance nodes less probable than this are not expanded (optional, " << DefaultSearchProbabilityThreshold << " by default)" << std::endl;
+    std::cout << "    " << NetworkEvaluatorArguments::TimeBudgetArgument           << " ms        - time budget per move, 0 for no limit (optional, " << DefaultSearchTimeBudget << " by default)" << std::endl;
+    std::cout << "    " << NetworkEvaluatorArguments::ThreadCountArgument          << " threads   - number of search threads (optional, " << DefaultSearchThreadCount << " by default)" << std::endl << std::endl;
 
     std::cout << "webapp mode - launches 2048 web application" << std::endl;
     std::cout << "    " << WebAppArguments::PortArgument                  << " port      - specify port to deploy app to (" << DefaultServerPort << " by default)" << std::endl;
     std::cout << "    " << WebAppArguments::ServerNameArgument            << " servName  - server name" << std::endl;
     std::cout << "    " << WebAppArguments::DocumentRootArgument          << " docRoot   - document root" << std::endl;
     std::cout << "    " << WebAppArguments::ResourcesDirectoryArgument    << " resDir    - resources directory" << std::endl;
-    std::cout << "    " << WebAppArguments::AppRootDirectoryArgument      << " appDir    - app root directory" << std::endl;
-    std::cout << "    " << WebAppArguments::NeuralNetworkFileNameArgument << " netFile   - neural network file name (optional)" << std::endl;
+    std::cout << "    " << WebAppArguments::AppRootDirectoryArgument      << " appDir    - app root directory, games above the threshold are recorded there" << std::endl;
+    std::cout << "                   into compressed .nnrz files read by merge and qlearn modes" << std::endl;
+    std::cout << "    " << WebAppArguments::NeuralNetworkFileNameArgument << " netFile   - FANN, json neural network or n-tuple network file name (optional)" << std::endl;
     std::cout << "    " << WebAppArguments::HighscoreThresholdArgument    << " score     - threshold above which games are recorded (optional, " << DefaultHighscoreToRecordThreshold << " by default)" << std::endl;
+    std::cout << "    " << WebAppArguments::SearchDepthArgument           << " depth     - expectimax search depth (optional, " << DefaultSearchDepth << " by default)" << std::endl;
+    std::cout << "    " << WebAppArguments::SearchTimeBudgetArgument      << " ms        - expectimax time budget per move (optional, " << DefaultSearchTimeBudget << " by default)" << std::endl;
+    std::cout << "    " << WebAppArguments::SearchThreadCountArgument     << " threads   - expectimax search threads (optional, " << DefaultSearchThreadCount << " by default)" << std::endl;
+    std::cout << "    " << WebAppArguments::InferenceLatencyArgument      << " us        - time requests of all sessions gather into one network batch (optional, " << DefaultInferenceLatency << " by default)" << std::endl;
+    std::cout << "    " << WebAppArguments::InferenceThreadCountArgument  << " threads   - network inference threads shared by sessions (optional, " << DefaultInferenceThreadCount << " by default)" << std::endl;
+    std::cout << "    " << WebAppArguments::ModelReloadIntervalArgument   << " seconds   - how often network file is checked for a new model, 0 disables reloading (optional, " << DefaultModelReloadInterval << " by default)" << std::endl;
+    std::cout << "    " << WebAppArguments::SpectatorMoveIntervalArgument << " ms        - move interval of the broadcast game (optional, " << DefaultSpectatorMoveInterval << " by default)" << std::endl;
+    std::cout << "    Games are played by the network with ?controller=neural (greedy) or ?controller=expectimax (search)." << std::endl;
+    std::cout << "    Moves follow each other after ?delay=ms (" << DefaultMoveDelay << " by default), ?delay=fast plays without delay." << std::endl;
+    std::cout << "    ?controller=spectator watches one game played by the network and shared by all spectators." << std::endl;
+
+    std::cout << "loadtest mode - plays many webapp sessions in this process and reports throughput, latency, CPU and memory" << std::endl;
+    std::cout << "    " << LoadTestArguments::ControllerArgument            << " controller - keyboard (random moves), neural or expectimax (optional, " << LoadTestArguments::KeyboardControllerValue << " by default)" << std::endl;
+    std::cout << "    " << LoadTestArguments::NeuralNetworkFileNameArgument << " netFile    - network file, required by neural and expectimax controllers" << std::endl;
+    std::cout << "    " << LoadTestArguments::AppRootDirectoryArgument      << " appDir     - directory high score games are recorded to (optional, games are not recorded by default)" << std::endl;
+    std::cout << "    " << LoadTestArguments::SessionCountArgument          << " sessions   - number of simulated sessions (optional, " << DefaultLoadTestSessionCount << " by default)" << std::endl;
+    std::cout << "    " << LoadTestArguments::MoveRateArgument              << " rate       - moves per second of every session, 0 plays without delay (optional, " << DefaultLoadTestMoveRate << " by default)" << std::endl;
+    std::cout << "    " << LoadTestArguments::DurationArgument              << " seconds    - test duration (optional, " << DefaultLoadTestDuration << " by default)" << std::endl;
+    std::cout << "    " << LoadTestArguments::ThreadCountArgument           << " threads    - driver threads sessions are split between (optional, " << DefaultLoadTestThreadCount << " by default)" << std::endl;
+    std::cout << "    " << LoadTestArguments::SearchDepthArgument           << " depth      - expectimax search depth (optional, " << DefaultSearchDepth << " by default)" << std::endl;
+    std::cout << "    " << LoadTestArguments::SearchTimeBudgetArgument      << " ms         - expectimax time budget per move (optional, " << DefaultSearchTimeBudget << " by default)" << std::endl;
+    std::cout << "    " << LoadTestArguments::SearchThreadCountArgument     << " threads    - expectimax search threads (optional, " << DefaultSearchThreadCount << " by default)" << std::endl;
+    std::cout << "    " << LoadTestArguments::InferenceLatencyArgument      << " us         - time requests of all sessions gather into one network batch (optional, " << DefaultInferenceLatency << " by default)" << std::endl;
+    std::cout << "    " << LoadTestArguments::InferenceThreadCountArgument  << " threads    - network inference threads shared by sessions (optional, " << DefaultInferenceThreadCount << " by default)" << std::endl;
 }
 
 }
@@ -1,20 +1,27 @@
 #include "Launcher.h"
 #include <map>
-#include <iostream>
 #include <cstring>
 #include <cmath>
+#include <cstdlib>
 #include "Helper.h"
 #include "ReplayMemoryMerger.h"
 #include "NetworkCreator.h"
 #include "NetworkTeacher.h"
 #include "QLearningTeacher.h"
+#include "NTupleTeacher.h"
+#include "NetworkEvaluator.h"
 #include "WebAppLauncher.h"
+#include "LoadTester.h"
 #include "utils/Defaults.h"
+#include "utils/Logger.h"
+#include "utils/RandomService.h"
 #include "arguments/ReplayMemoryMergerArgumentsParser.h"
 #include "arguments/NetworkCreatorArgumentsParser.h"
 #include "arguments/NetworkTeacherArgumentsParser.h"
 #include "arguments/QLearningArgumentsParser.h"
+#include "arguments/NetworkEvaluatorArgumentsParser.h"
 #include "arguments/WebAppArgumentsParser.h"
+#include "arguments/LoadTestArgumentsParser.h"
 
 namespace nn2048
 {
@@ -35,7 +42,9 @@ RunMode Launcher::parseRunMode(const std::string &mode)
         { "create", RunMode::CreateNetwork },
         { "learn", RunMode::NetworkLearning },
         { "qlearn", RunMode::QNetworkLearning },
-        { "webapp", RunMode::WebApp }
+        { "evaluate", RunMode::NetworkEvaluation },
+        { "webapp", RunMode::WebApp },
+        { "loadtest", RunMode::LoadTest }
     };
     return dictionary[mode];
 }
@@ -52,8 +61,12 @@ std::unique_ptr<Application> Launcher::applicationForRunMode(RunMode mode, int a
         return networkTeacherApplication(argc, argv);
     case RunMode::QNetworkLearning:
         return qNetworkTeacherApplication(argc, argv);
+    case RunMode::NetworkEvaluation:
+        return networkEvaluatorApplication(argc, argv);
     case RunMode::WebApp:
         return webApplication(argc, argv);
+    case RunMode::LoadTest:
+        return loadTestApplication(argc, argv);
     case RunMode::HelpMode:
     default:
         return helperApplication(argv[0]);
@@ -65,12 +78,30 @@ std::unique_ptr<Application> Launcher::helperApplication(const std::string &exec
     return std::make_unique<Helper>(execName);
 }
 
+void Launcher::setupLogger(const Arguments &arguments)
+{
+    Logger::setLevel(arguments.logLevel);
+}
+
+void Launcher::seedRandomService(const Arguments &arguments)
+{
+    auto seed = arguments.hasSeed ? arguments.seed : RandomService::randomSeed();
+    RandomService::setSeed(seed);
+    LOG_INFO << "Random seed: " << seed;
+
+    // Game core and network libraries still draw from std::rand
+    auto environmentStream = RandomService::stream("environment");
+    std::srand(static_cast<unsigned>(environmentStream()));
+}
+
 std::unique_ptr<Application> Launcher::replayMemoryMergerApplication(int argc, char *argv[])
 {
     auto parser = ReplayMemoryMergerArgumentsParser(argc, argv);
     auto arguments = parser.parsedArguments();
     if (!arguments)
         return nullptr;
+    setupLogger(*arguments);
+    seedRandomService(*arguments);
     auto pointer = dynamic_cast<ReplayMemoryMergerArguments *>(arguments.release());
     return std::make_unique<ReplayMemoryMerger>(std::unique_ptr<ReplayMemoryMergerArguments>(pointer));
 }
@@ -81,6 +112,8 @@ std::unique_ptr<Application> Launcher::networkCreatorApplication(int argc, char
     auto arguments = parser.parsedArguments();
     if (!arguments)
         return nullptr;
+    setupLogger(*arguments);
+    seedRandomService(*arguments);
     auto pointer = dynamic_cast<NetworkCreatorArguments *>(arguments.release());
     return std::make_unique<NetworkCreator>(std::unique_ptr<NetworkCreatorArguments>(pointer));
 }
@@ -91,6 +124,8 @@ std::unique_ptr<Application> Launcher::networkTeacherApplication(int argc, char
     auto arguments = parser.parsedArguments();
     if (!arguments)
         return nullptr;
+    setupLogger(*arguments);
+    seedRandomService(*arguments);
     auto pointer = dynamic_cast<NetworkTeacherArguments *>(arguments.release());
     return std::make_unique<NetworkTeacher>(std::unique_ptr<NetworkTeacherArguments>(pointer));
 }
@@ -101,20 +136,48 @@ std::unique_ptr<Application> Launcher::qNetworkTeacherApplication(int argc, char
     auto arguments = parser.parsedArguments();
     if (!arguments)
         return nullptr;
+    setupLogger(*arguments);
+    seedRandomService(*arguments);
     auto pointer = dynamic_cast<QLearningArguments *>(arguments.release());
+    if (NTupleNetwork::isNTupleNetworkFile(pointer->networkFileName))
+        return std::make_unique<NTupleTeacher>(std::unique_ptr<QLearningArguments>(pointer));
     return std::make_unique<QLearningTeacher>(std::unique_ptr<QLearningArguments>(pointer));
 }
 
+std::unique_ptr<Application> Launcher::networkEvaluatorApplication(int argc, char *argv[])
+{
+    auto parser = NetworkEvaluatorArgumentsParser(argc, argv);
+    auto arguments = parser.parsedArguments();
+    if (!arguments)
+        return nullptr;
+    setupLogger(*arguments);
+    seedRandomService(*arguments);
+    auto pointer = dynamic_cast<NetworkEvaluatorArguments *>(arguments.release());
+    return std::make_unique<NetworkEvaluator>(std::unique_ptr<NetworkEvaluatorArguments>(pointer));
+}
+
 std::unique_ptr<Application> Launcher::webApplication(int argc, char *argv[])
 {
     auto parser = WebAppArgumentsParser(argc, argv);
     auto arguments = parser.parsedArguments();
     if (!arguments)
         return nullptr;
+    setupLogger(*arguments);
+    seedRandomService(*arguments);
     auto pointer = dynamic_cast<WebAppArguments *>(arguments.release());
     return std::make_unique<WebAppLauncher>(std::unique_ptr<WebAppArguments>(pointer));
 }
 
+std::unique_ptr<Application> Launcher::loadTestApplication(int argc, char *argv[])
+{
+    auto parser = LoadTestArgumentsParser(argc, argv);
+    auto arguments = parser.parsedArguments();
+    if (!arguments)
+        return nullptr;
+    setupLogger(*arguments);
+    seedRandomService(*arguments);
+    auto pointer = dynamic_cast<LoadTestArguments *>(arguments.release());
+    return std::make_unique<LoadTester>(std::unique_ptr<LoadTestArguments>(pointer));
 }
 
-
+}
@@ -5,6 +5,7 @@
 #include <memory>
 #include <vector>
 #include "Application.h"
+#include "arguments/Arguments.h"
 
 namespace nn2048
 {
@@ -16,7 +17,9 @@ enum class RunMode
     CreateNetwork,
     NetworkLearning,
     QNetworkLearning,
-    WebApp
+    NetworkEvaluation,
+    WebApp,
+    LoadTest
 };
 
 class Launcher
@@ -28,11 +31,15 @@ protected:
     static RunMode parseRunMode(const std::string &mode);
     static std::unique_ptr<Application> applicationForRunMode(RunMode mode, int argc, char *argv[]);
     static std::unique_ptr<Application> helperApplication(const std::string &execName);
+    static void setupLogger(const Arguments &arguments);
+    static void seedRandomService(const Arguments &arguments);
     static std::unique_ptr<Application> replayMemoryMergerApplication(int argc, char *argv[]);
     static std::unique_ptr<Application> networkCreatorApplication(int argc, char *argv[]);
     static std::unique_ptr<Application> networkTeacherApplication(int argc, char *argv[]);
     static std::unique_ptr<Application> qNetworkTeacherApplication(int argc, char *argv[]);
+    static std::unique_ptr<Application> networkEvaluatorApplication(int argc, char *argv[]);
     static std::unique_ptr<Application> webApplication(int argc, char *argv[]);
+    static std::unique_ptr<Application> loadTestApplication(int argc, char *argv[]);
 
     static std::vector<std::string> splitString(const std::string &string, char delimiter);
 };
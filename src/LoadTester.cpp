@@ -0,0 +1,418 @@
+#include "LoadTester.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <GameCore.h>
+#include <Wt/Test/WTestEnvironment.h>
+#include "utils/Logger.h"
+#include "utils/ModelReloader.h"
+#include "utils/NetworkOutputConverter.h"
+#include "web/WebApplication.h"
+
+namespace nn2048
+{
+
+namespace
+{
+
+/// Request parameter WebApplication picks the session controller by
+const std::string ControllerParameterName = "controller";
+
+double cpuSeconds()
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+            + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+/// Current resident set size in KiB, 0 when it cannot be read
+long residentKilobytes()
+{
+    std::ifstream statm("/proc/self/statm");
+    long totalPages = 0, residentPages = 0;
+    if (!(statm >> totalPages >> residentPages))
+        return 0;
+    return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+long peakResidentKilobytes()
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/// Plays the best ranked move which changes the board
+bool playRankedMoves(WebApplication &application, const DirectionSignalVector &moves)
+{
+    for (auto &move: moves)
+        if (application.playMove(move.first))
+            return true;
+    return false;
+}
+
+double percentile(const std::vector<std::uint32_t> &sorted, double fraction)
+{
+    if (sorted.empty())
+        return 0.0;
+    auto index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1));
+    return sorted[index] / 1000.0;
+}
+
+}
+
+struct LoadTester::Session
+{
+    /// Declared first, application has to be destroyed before its environment
+    std::unique_ptr<Wt::Test::WTestEnvironment> environment;
+    std::unique_ptr<WebApplication> application;
+    std::chrono::steady_clock::time_point nextMove;
+    bool waiting = false;
+};
+
+struct LoadTester::Completion
+{
+    Session *session;
+    std::vector<double> moveValues;
+    std::chrono::steady_clock::time_point issued;
+};
+
+struct LoadTester::Driver
+{
+    std::vector<Session> sessions;
+    std::unique_ptr<ExpectimaxSearch> search;
+
+    /// Inference results, filled on inference threads and applied by the driver
+    std::mutex completionsMutex;
+    std::condition_variable completionsCondition;
+    std::vector<Completion> completions;
+    unsigned waitingCount = 0;
+
+    /// Move latencies in microseconds
+    std::vector<std::uint32_t> latencies;
+    std::uint64_t moveCount = 0;
+    std::uint64_t stuckMoveCount = 0;
+    std::thread thread;
+};
+
+LoadTester::LoadTester(std::unique_ptr<LoadTestArguments> arguments):
+    _arguments(std::move(arguments)),
+    _moveInterval(_arguments->moveRate > 0 ? std::chrono::steady_clock::duration(std::chrono::seconds(1)) / _arguments->moveRate
+                                           : std::chrono::steady_clock::duration::zero()),
+    _sigIntCaught(false),
+    _stopping(false),
+    _readyDrivers(0),
+    _phase(Phase::CreateEnvironments)
+{}
+
+LoadTester::~LoadTester()
+{}
+
+int LoadTester::run()
+{
+    bool keyboard = _arguments->controller == LoadTestArguments::KeyboardControllerValue;
+    if (!keyboard && !loadEvaluator())
+        return -1;
+    if (_arguments->controller == LoadTestArguments::NeuralNetworkControllerValue)
+        _inferenceService = std::make_unique<InferenceService>(_evaluator.get(),
+                                                               std::chrono::microseconds(_arguments->inferenceLatency),
+                                                               _arguments->inferenceThreadCount,
+                                                               DefaultInferenceBatchSize);
+    if (!_arguments->appRootDirectory.empty()) {
+        try {
+            _replayRecorder = std::make_unique<ReplayRecorder>(_arguments->appRootDirectory);
+        } catch (std::runtime_error &exception) {
+            LOG_ERROR << "Replay recorder could not be started: " << exception.what();
+            return -1;
+        }
+    }
+    if (_arguments->controller == LoadTestArguments::ExpectimaxControllerValue && _arguments->searchThreadCount > 1)
+        _searchThreadPool = std::make_unique<ThreadPool>();
+    _metrics = std::make_unique<WebAppMetrics>();
+
+    LOG_INFO << "Load test: " << _arguments->sessionCount << " " << _arguments->controller << " sessions, "
+             << _arguments->moveRate << " moves/s each, " << _arguments->duration << " s, "
+             << _arguments->threadCount << " driver threads";
+
+    // Sessions are created on their driver threads and used only there
+    auto setupStart = std::chrono::steady_clock::now();
+    auto memoryBefore = residentKilobytes();
+    auto driverCount = std::min(_arguments->threadCount, _arguments->sessionCount);
+    for (unsigned i = 0; i < driverCount; ++i) {
+        auto sessionCount = _arguments->sessionCount / driverCount + (i < _arguments->sessionCount % driverCount ? 1 : 0);
+        _drivers.push_back(std::make_unique<Driver>());
+        if (_arguments->controller == LoadTestArguments::ExpectimaxControllerValue)
+            _drivers.back()->search = std::make_unique<ExpectimaxSearch>(_evaluator.get(), searchSettings());
+        _drivers.back()->thread = std::thread(&LoadTester::runDriver, this, std::ref(*_drivers.back()),
+                                              sessionCount, RandomService::stream("load-test", i));
+    }
+
+    // Every test environment builds its own configuration, its cost is not part of a session
+    waitForDrivers(driverCount);
+    auto environmentMemory = (residentKilobytes() - memoryBefore) / static_cast<long>(_arguments->sessionCount);
+    memoryBefore = residentKilobytes();
+    startPhase(Phase::CreateApplications);
+
+    waitForDrivers(driverCount);
+    std::chrono::duration<double> setupTime = std::chrono::steady_clock::now() - setupStart;
+    auto sessionMemory = (residentKilobytes() - memoryBefore) / static_cast<long>(_arguments->sessionCount);
+
+    auto start = std::chrono::steady_clock::now();
+    auto cpuStart = cpuSeconds();
+    startPhase(Phase::Run);
+
+    auto end = start + std::chrono::seconds(_arguments->duration);
+    while (!_sigIntCaught && std::chrono::steady_clock::now() < end)
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    _stopping = true;
+    for (auto &driver: _drivers)
+        driver->thread.join();
+
+    std::chrono::duration<double> testTime = std::chrono::steady_clock::now() - start;
+    report(testTime.count(), cpuSeconds() - cpuStart, setupTime.count(), sessionMemory, environmentMemory);
+    return 0;
+}
+
+void LoadTester::onSigInt()
+{
+    LOG_INFO << "SIGINT caught. Finishing load test...";
+    _sigIntCaught = true;
+}
+
+bool LoadTester::loadEvaluator()
+{
+    try {
+        _evaluator = ModelReloader::load(_arguments->neuralNetworkFileName);
+    } catch (std::runtime_error &exception) {
+        LOG_ERROR << "Neural network loading failed: " << exception.what();
+        return false;
+    }
+    return true;
+}
+
+ExpectimaxSettings LoadTester::searchSettings() const
+{
+    ExpectimaxSettings settings;
+    settings.depth = _arguments->searchDepth;
+    settings.timeBudget = _arguments->searchTimeBudget;
+    settings.threadCount = _arguments->searchThreadCount;
+    settings.threadPool = _searchThreadPool.get();
+    return settings;
+}
+
+void LoadTester::waitForDrivers(unsigned driverCount)
+{
+    std::unique_lock<std::mutex> lock(_phaseMutex);
+    _phaseCondition.wait(lock, [this, driverCount] () { return _readyDrivers == driverCount; });
+}
+
+void LoadTester::startPhase(Phase phase)
+{
+    {
+        std::lock_guard<std::mutex> lock(_phaseMutex);
+        _readyDrivers = 0;
+        _phase = phase;
+    }
+    _phaseCondition.notify_all();
+}
+
+void LoadTester::finishPhase(Phase next)
+{
+    std::unique_lock<std::mutex> lock(_phaseMutex);
+    ++_readyDrivers;
+    _phaseCondition.notify_all();
+    _phaseCondition.wait(lock, [this, next] () { return _phase == next; });
+}
+
+void LoadTester::runDriver(Driver &driver, unsigned sessionCount, RandomStream random)
+{
+    createEnvironments(driver, sessionCount);
+    finishPhase(Phase::CreateApplications);
+    createApplications(driver);
+    finishPhase(Phase::Run);
+
+    // Sessions start at once but their moves are spread over the first interval
+    auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < driver.sessions.size(); ++i)
+        driver.sessions[i].nextMove = now + _moveInterval * static_cast<long>(i) / static_cast<long>(driver.sessions.size());
+
+    while (!_stopping) {
+        applyCompletions(driver);
+        now = std::chrono::steady_clock::now();
+        auto wakeUp = now + std::chrono::milliseconds(DefaultSchedulerTick);
+        for (auto &session: driver.sessions) {
+            if (session.waiting)
+                continue;
+            if (session.nextMove <= now) {
+                makeMove(driver, session, random);
+                now = std::chrono::steady_clock::now();
+            }
+            if (!session.waiting)
+                wakeUp = std::min(wakeUp, session.nextMove);
+        }
+
+        // Inference results wake the driver before the next due move
+        std::unique_lock<std::mutex> lock(driver.completionsMutex);
+        driver.completionsCondition.wait_until(lock, wakeUp, [&driver] () { return !driver.completions.empty(); });
+    }
+
+    waitForRequests(driver);
+    driver.sessions.clear();
+}
+
+void LoadTester::createEnvironments(Driver &driver, unsigned sessionCount)
+{
+    // Sessions pick their controller from the request like browser sessions do
+    Wt::Http::ParameterMap parameters;
+    parameters[ControllerParameterName] = { _arguments->controller };
+    driver.sessions.resize(sessionCount);
+    for (auto &session: driver.sessions) {
+        session.environment = std::make_unique<Wt::Test::WTestEnvironment>();
+        session.environment->setParameterMap(parameters);
+    }
+}
+
+void LoadTester::createApplications(Driver &driver)
+{
+    // Games are recorded only into an explicit directory, never next to the binary
+    auto highscoreThreshold = _replayRecorder ? DefaultHighscoreToRecordThreshold : std::numeric_limits<unsigned long>::max();
+    for (auto &session: driver.sessions)
+        session.application = std::make_unique<WebApplication>(*session.environment, _evaluator.get(), _inferenceService.get(),
+                                                               searchSettings(), highscoreThreshold, _replayRecorder.get(),
+                                                               nullptr, nullptr, _metrics.get());
+}
+
+void LoadTester::makeMove(Driver &driver, Session &session, RandomStream &random)
+{
+    auto issued = std::chrono::steady_clock::now();
+    session.nextMove = issued + _moveInterval;
+    auto &application = *session.application;
+
+    if (_inferenceService) {
+        PackedBoard board;
+        {
+            Wt::WApplication::UpdateLock lock(&application);
+            board = application.board();
+        }
+        session.waiting = true;
+        {
+            std::lock_guard<std::mutex> lock(driver.completionsMutex);
+            ++driver.waitingCount;
+        }
+        auto sessionPointer = &session;
+        _inferenceService->submit(board, [&driver, sessionPointer, issued] (const std::vector<double> &values) {
+            {
+                std::lock_guard<std::mutex> lock(driver.completionsMutex);
+                driver.completions.push_back({ sessionPointer, values, issued });
+            }
+            driver.completionsCondition.notify_one();
+        });
+        return;
+    }
+
+    bool moved;
+    if (driver.search) {
+        PackedBoard board;
+        {
+            Wt::WApplication::UpdateLock lock(&application);
+            board = application.board();
+        }
+        auto moves = driver.search->rankMoves(board);
+        Wt::WApplication::UpdateLock lock(&application);
+        moved = playRankedMoves(application, moves);
+    } else {
+        auto direction = static_cast<Game2048Core::Direction>(random() % static_cast<unsigned>(Game2048Core::Direction::Total));
+        Wt::WApplication::UpdateLock lock(&application);
+        moved = application.playMove(direction);
+    }
+
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - issued);
+    driver.latencies.push_back(static_cast<std::uint32_t>(latency.count()));
+    ++driver.moveCount;
+    if (!moved)
+        ++driver.stuckMoveCount;
+}
+
+void LoadTester::applyCompletions(Driver &driver)
+{
+    std::vector<Completion> completions;
+    {
+        std::lock_guard<std::mutex> lock(driver.completionsMutex);
+        completions.swap(driver.completions);
+        driver.waitingCount -= static_cast<unsigned>(completions.size());
+    }
+
+    for (auto &completion: completions) {
+        auto &session = *completion.session;
+        bool moved = false;
+        if (!completion.moveValues.empty()) {
+            Wt::WApplication::UpdateLock lock(session.application.get());
+            moved = playRankedMoves(*session.application, NetworkOutputConverter::outputToMoves(completion.moveValues));
+        }
+        session.waiting = false;
+
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - completion.issued);
+        driver.latencies.push_back(static_cast<std::uint32_t>(latency.count()));
+        ++driver.moveCount;
+        if (!moved)
+            ++driver.stuckMoveCount;
+    }
+}
+
+void LoadTester::waitForRequests(Driver &driver)
+{
+    // Callbacks keep pointers to sessions, so sessions outlive their requests
+    std::unique_lock<std::mutex> lock(driver.completionsMutex);
+    driver.completionsCondition.wait(lock, [&driver] () { return driver.completions.size() == driver.waitingCount; });
+    driver.waitingCount = 0;
+    driver.completions.clear();
+}
+
+void LoadTester::report(double seconds, double cpuSeconds, double setupSeconds, long sessionMemory,
+                        long environmentMemory) const
+{
+    std::vector<std::uint32_t> latencies;
+    std::uint64_t moveCount = 0;
+    std::uint64_t stuckMoveCount = 0;
+    for (auto &driver: _drivers) {
+        latencies.insert(latencies.end(), driver->latencies.begin(), driver->latencies.end());
+        moveCount += driver->moveCount;
+        stuckMoveCount += driver->stuckMoveCount;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    std::cout << "Sessions created in " << setupSeconds << " s, " << sessionMemory << " KiB resident per session, "
+              << environmentMemory << " KiB per test environment not included" << std::endl;
+    std::cout << "Sessions are not rendered, paint and server push costs are not measured" << std::endl;
+    std::cout << "Moves: " << moveCount << " in " << seconds << " s, " << moveCount / seconds << " moves/s, "
+              << stuckMoveCount << " did not change the board" << std::endl;
+    std::cout << "Move latency: p50 " << percentile(latencies, 0.5) << " ms, p90 " << percentile(latencies, 0.9)
+              << " ms, p99 " << percentile(latencies, 0.99) << " ms, max " << percentile(latencies, 1.0) << " ms" << std::endl;
+    std::cout << "CPU: " << cpuSeconds << " s, " << 100.0 * cpuSeconds / seconds << " % of one core" << std::endl;
+    std::cout << "Memory: " << residentKilobytes() / 1024 << " MiB resident, " << peakResidentKilobytes() / 1024 << " MiB peak" << std::endl;
+
+    std::uint64_t games = 0;
+    unsigned bestScore = 0;
+    for (unsigned i = 0; i < static_cast<unsigned>(WebAppMetrics::SessionType::Total); ++i) {
+        auto type = static_cast<WebAppMetrics::SessionType>(i);
+        games += _metrics->games(type);
+        bestScore = std::max(bestScore, _metrics->bestScore(type));
+    }
+    std::cout << "Games finished: " << games << ", best score " << bestScore << std::endl;
+    if (_inferenceService && _inferenceService->batchCount() > 0)
+        std::cout << "Inference: " << _inferenceService->requestCount() << " requests in " << _inferenceService->batchCount()
+                  << " batches, " << static_cast<double>(_inferenceService->requestCount()) / _inferenceService->batchCount()
+                  << " boards per batch" << std::endl;
+    if (_replayRecorder) {
+        auto recorded = _replayRecorder->statistics();
+        std::cout << "Recorded games: " << recorded.submittedGames << " submitted, " << recorded.droppedGames
+                  << " dropped, queue peak " << recorded.maxQueueDepth << "/" << recorded.queueCapacity << std::endl;
+    }
+}
+
+}
@@ -0,0 +1,92 @@
+#ifndef LOADTESTER_H
+#define LOADTESTER_H
+
+#include "Application.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "arguments/LoadTestArguments.h"
+#include "utils/BoardEvaluator.h"
+#include "utils/ExpectimaxSearch.h"
+#include "utils/InferenceService.h"
+#include "utils/RandomService.h"
+#include "utils/ReplayRecorder.h"
+#include "utils/ThreadPool.h"
+#include "utils/WebAppMetrics.h"
+
+namespace nn2048
+{
+
+class WebApplication;
+
+/// Measures how many sessions one webapp process sustains. Sessions are
+/// WebApplication instances in Wt test environments, so no server or
+/// browser is needed. They are created with the requested controller like
+/// browser sessions, but the driver threads make their moves at the
+/// requested rate: keyboard sessions play random directions, neural
+/// sessions go through the shared inference service and expectimax
+/// sessions search on the driver thread. Sessions are never rendered.
+/// Reports throughput, move latency percentiles, CPU time and memory.
+class LoadTester: public Application
+{
+public:
+    LoadTester(std::unique_ptr<LoadTestArguments> arguments);
+    ~LoadTester();
+
+    int run();
+    void onSigInt();
+
+protected:
+    /// Drivers create all environments, then all applications, so memory of both is measured apart
+    enum class Phase
+    {
+        CreateEnvironments,
+        CreateApplications,
+        Run
+    };
+
+    struct Session;
+    struct Completion;
+    struct Driver;
+
+    bool loadEvaluator();
+    ExpectimaxSettings searchSettings() const;
+    void waitForDrivers(unsigned driverCount);
+    void startPhase(Phase phase);
+    /// Called by a driver when it is done with the current phase
+    void finishPhase(Phase next);
+    void runDriver(Driver &driver, unsigned sessionCount, RandomStream random);
+    void createEnvironments(Driver &driver, unsigned sessionCount);
+    void createApplications(Driver &driver);
+    void makeMove(Driver &driver, Session &session, RandomStream &random);
+    void applyCompletions(Driver &driver);
+    void waitForRequests(Driver &driver);
+    void report(double seconds, double cpuSeconds, double setupSeconds, long sessionMemory,
+                long environmentMemory) const;
+
+private:
+    std::unique_ptr<LoadTestArguments> _arguments;
+    std::chrono::steady_clock::duration _moveInterval;
+    std::atomic<bool> _sigIntCaught;
+    std::atomic<bool> _stopping;
+
+    std::mutex _phaseMutex;
+    std::condition_variable _phaseCondition;
+    unsigned _readyDrivers;
+    Phase _phase;
+
+    std::shared_ptr<const BoardEvaluator> _evaluator;
+    std::unique_ptr<WebAppMetrics> _metrics;
+    std::unique_ptr<ReplayRecorder> _replayRecorder;
+    std::unique_ptr<ThreadPool> _searchThreadPool;
+    std::vector<std::unique_ptr<Driver>> _drivers;
+    /// Destroyed first, its remaining callbacks still reach the drivers
+    std::unique_ptr<InferenceService> _inferenceService;
+};
+
+}
+
+#endif // LOADTESTER_H
@@ -0,0 +1,158 @@
+#include "NTupleTeacher.h"
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "utils/Logger.h"
+#include "utils/RandomService.h"
+
+namespace nn2048
+{
+
+NTupleTeacher::NTupleTeacher(std::unique_ptr<QLearningArguments> arguments):
+    _arguments(std::move(arguments)),
+    _sigIntCaught(false),
+    _game(std::make_unique<Game2048Core::GameCore>(4))
+{}
+
+int NTupleTeacher::run()
+{
+    _network = loadNetwork();
+    if (!_network)
+        return -1;
+
+    LOG_INFO << "Learning starts...";
+    performLearning();
+    serializeNetwork();
+    return 0;
+}
+
+void NTupleTeacher::onSigInt()
+{
+    _sigIntCaught = true;
+}
+
+std::unique_ptr<NTupleNetwork> NTupleTeacher::loadNetwork() const
+{
+    try {
+        LOG_INFO << "Loading n-tuple network...";
+
+        auto network = NTupleNetwork::load(_arguments->networkFileName);
+
+        LOG_INFO << "N-tuple network loaded";
+        return network;
+    } catch (std::runtime_error &exception) {
+        LOG_ERROR << "N-tuple network loading failed: " << exception.what();
+    }
+    return nullptr;
+}
+
+void NTupleTeacher::performLearning()
+{
+    unsigned age = 0;
+    unsigned agentStepCount = 0;
+    double errorSum = 0.0;
+    bool hasPrevAfterstate = false;
+    PackedBoard prevAfterstate = 0;
+    auto shouldContinueLearning = learningCondition(age, _game->state().score);
+    auto gameStart = std::chrono::steady_clock::now();
+
+    auto actorRandom = RandomService::stream("actor");
+    const unsigned directionCount = static_cast<unsigned>(Game2048Core::Direction::Total);
+
+    while (shouldContinueLearning() && !_sigIntCaught)
+    {
+        auto board = BoardPacker::pack(_game->board());
+        if (_game->isGameOver())
+        {
+            // Nothing follows the last afterstate
+            if (hasPrevAfterstate)
+                errorSum += std::abs(_network->update(prevAfterstate, 0.0, _arguments->learningRate));
+            std::chrono::duration<double> gameTime = std::chrono::steady_clock::now() - gameStart;
+            printStats(age, _game->score(), agentStepCount, errorSum / agentStepCount, agentStepCount / gameTime.count());
+            _game->reset();
+            hasPrevAfterstate = false;
+            agentStepCount = 0;
+            errorSum = 0.0;
+            gameStart = std::chrono::steady_clock::now();
+            continue;
+        }
+
+        auto direction = pickDirection(board, actorRandom.nextDouble(),
+                                       static_cast<unsigned>(actorRandom.nextIndex(directionCount)));
+        unsigned reward;
+        auto afterstate = BoardPacker::move(board, direction, reward);
+        if (!_game->tryMove(direction)) {
+            LOG_ERROR << "Picked move was rejected by game core. Aborting";
+            break;
+        }
+
+        if (hasPrevAfterstate) {
+            double target = reward + _network->value(afterstate);
+            errorSum += std::abs(_network->update(prevAfterstate, target, _arguments->learningRate));
+        }
+        prevAfterstate = afterstate;
+        hasPrevAfterstate = true;
+
+        ++age;
+        ++agentStepCount;
+    }
+    LOG_INFO << "Learning finished at age " << age;
+}
+
+Game2048Core::Direction NTupleTeacher::pickDirection(PackedBoard board, double randomValue, unsigned randomDirection) const
+{
+    const unsigned directionCount = static_cast<unsigned>(Game2048Core::Direction::Total);
+    auto bestDirection = Game2048Core::Direction::None;
+    double bestValue = std::numeric_limits<double>::lowest();
+    bool explore = randomValue <= _arguments->epsilonFactor;
+
+    for (unsigned i = 0; i < directionCount; ++i) {
+        // Exploration picks first legal direction starting from a random one
+        auto direction = static_cast<Game2048Core::Direction>(explore ? (randomDirection + i) % directionCount : i);
+        unsigned reward;
+        auto afterstate = BoardPacker::move(board, direction, reward);
+        if (afterstate == board)
+            continue;
+        if (explore)
+            return direction;
+        double value = reward + _network->value(afterstate);
+        if (value > bestValue) {
+            bestValue = value;
+            bestDirection = direction;
+        }
+    }
+    return bestDirection;
+}
+
+void NTupleTeacher::serializeNetwork() const
+{
+    LOG_INFO << "Serializing network...";
+    if (_network->save(_arguments->networkFileName))
+        LOG_INFO << "Network serialized";
+    else
+        LOG_ERROR << "Network serialization failed";
+}
+
+std::function<bool()> NTupleTeacher::learningCondition(const unsigned &age, const unsigned &score) const
+{
+    if (_arguments->maxAge > 0 && _arguments->targetScore > 0)
+        return [&age, &score, this] () { return age < _arguments->maxAge && score < _arguments->targetScore; };
+    else if (_arguments->maxAge > 0)
+        return [&age, this] () { return age < _arguments->maxAge; };
+    else if (_arguments->targetScore > 0)
+        return [&score, this] () { return score < _arguments->targetScore; };
+    return [] () { return false; };
+}
+
+void NTupleTeacher::printStats(unsigned age, unsigned score, unsigned steps, double averageError, double movesPerSecond) const
+{
+    std::cout << "[age:\t" << age
+              << "] score:\t" << score
+              << ", steps:\t" << steps
+              << ", average TD error:\t" << averageError
+              << ", moves/s:\t" << movesPerSecond << std::endl;
+}
+
+}
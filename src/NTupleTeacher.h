@@ -0,0 +1,41 @@
+#ifndef NTUPLETEACHER_H
+#define NTUPLETEACHER_H
+
+#include "Application.h"
+#include <memory>
+#include <functional>
+#include <GameCore.h>
+#include "arguments/QLearningArguments.h"
+#include "utils/NTupleNetwork.h"
+
+namespace nn2048
+{
+
+/// qlearn mode for n-tuple networks. Afterstate values are learned with TD(0)
+/// while playing greedily with respect to merge reward plus afterstate value.
+class NTupleTeacher: public Application
+{
+public:
+    NTupleTeacher(std::unique_ptr<QLearningArguments> arguments);
+
+    int run();
+    void onSigInt();
+
+protected:
+    std::unique_ptr<NTupleNetwork> loadNetwork() const;
+    void performLearning();
+    Game2048Core::Direction pickDirection(PackedBoard board, double randomValue, unsigned randomDirection) const;
+    void serializeNetwork() const;
+    std::function<bool()> learningCondition(const unsigned &age, const unsigned &score) const;
+    void printStats(unsigned age, unsigned score, unsigned steps, double averageError, double movesPerSecond) const;
+
+private:
+    std::unique_ptr<QLearningArguments> _arguments;
+    bool _sigIntCaught;
+    std::unique_ptr<NTupleNetwork> _network;
+    std::unique_ptr<Game2048Core::GameCore> _game;
+};
+
+}
+
+#endif // NTUPLETEACHER_H
@@ -1,7 +1,8 @@
 #include "NetworkCreator.h"
 #include <NetworkSerializer.h>
 #include <fstream>
-#include <iostream>
+#include "utils/Logger.h"
+#include "utils/NTupleNetwork.h"
 
 namespace nn2048
 {
@@ -12,35 +13,41 @@ NetworkCreator::NetworkCreator(std::unique_ptr<NetworkCreatorArguments> argument
 
 int NetworkCreator::run()
 {
+    if (_arguments->createNTupleNetwork)
+    {
+        createNTupleNetwork();
+        return 0;
+    }
+
     if (_arguments->networkStructure.size() < 2)
     {
-        std::cerr << "Network structure has to have at least two values (input count, neuron count)." << std::endl;
+        LOG_ERROR << "Network structure has to have at least two values (input count, neuron count).";
         return 0;
     }
 
     if (!_arguments->createFannNetwork)
     {
-        std::cout << "Creating network... ";
+        LOG_INFO << "Creating network...";
         auto network = createNetwork();
         if (!network)
         {
-            std::cout << "failed" << std::endl;
+            LOG_ERROR << "Network creation failed";
             return 0;
         }
-        else std::cout << "ok" << std::endl;
+        LOG_INFO << "Network created";
 
         serialize(network.get());
     }
     else
     {
-        std::cout << "Creating network...";
+        LOG_INFO << "Creating network...";
         auto network = createFann();
         if (!network)
         {
-            std::cout << "failed" << std::endl;
+            LOG_ERROR << "Network creation failed";
             return 0;
         }
-        else std::cout << "ok" << std::endl;
+        LOG_INFO << "Network created";
 
         serializeFann(network.get());
     }
@@ -88,25 +95,22 @@ void NetworkCreator::serialize(const NeuralNetwork::Network *network) const
 {
     try
     {
-        std::cout << "Serializing...";
-        std::cout.flush();
+        LOG_INFO << "Serializing...";
 
         std::ofstream file(_arguments->networkFileName);
         if (!file.is_open())
         {
-            std::cout << "failed" << std::endl;
-            std::cerr << "Could not open file " << _arguments->networkFileName << std::endl;
+            LOG_ERROR << "Serialization failed, could not open file " << _arguments->networkFileName;
             return;
         }
 
         NeuralNetwork::NetworkSerializer::serialize(network, file);
         file.close();
-        std::cout << "ok" << std::endl;
+        LOG_INFO << "Network serialized";
     }
     catch (std::runtime_error &exception)
     {
-        std::cout << "failed" << std::endl;
-        std::cerr << "Runtime exception: " << exception.what() << std::endl;
+        LOG_ERROR << "Serialization failed: " << exception.what();
     }
 }
 
@@ -127,13 +131,24 @@ std::unique_ptr<FANN::neural_net> NetworkCreator::createFann() const
 
 void NetworkCreator::serializeFann(FANN::neural_net *network) const
 {
-    std::cout << "Serializing... ";
+    LOG_INFO << "Serializing...";
     if (network->save(_arguments->networkFileName))
-        std::cout << "ok" << std::endl;
+        LOG_INFO << "Network serialized";
     else
-        std::cout << "failed" << std::endl;
+        LOG_ERROR << "Serialization failed";
 }
 
+void NetworkCreator::createNTupleNetwork() const
+{
+    LOG_INFO << "Creating n-tuple network...";
+    NTupleNetwork network;
+
+    LOG_INFO << "Serializing...";
+    if (network.save(_arguments->networkFileName))
+        LOG_INFO << "Network serialized";
+    else
+        LOG_ERROR << "Serialization failed";
 }
 
+}
 
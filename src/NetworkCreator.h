@@ -30,6 +30,8 @@ protected:
     std::unique_ptr<FANN::neural_net> createFann() const;
     void serializeFann(FANN::neural_net *network) const;
 
+    void createNTupleNetwork() const;
+
 private:
     std::unique_ptr<NetworkCreatorArguments> _arguments;
 };
@@ -0,0 +1,129 @@
+#include "NetworkEvaluator.h"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <GameCore.h>
+#include <NetworkSerializer.h>
+#include "utils/BoardPacker.h"
+#include "utils/FannBoardEvaluator.h"
+#include "utils/Logger.h"
+#include "utils/NetworkBoardEvaluator.h"
+#include "utils/NTupleNetwork.h"
+
+namespace nn2048
+{
+
+NetworkEvaluator::NetworkEvaluator(std::unique_ptr<NetworkEvaluatorArguments> arguments):
+    _arguments(std::move(arguments)),
+    _sigIntCaught(false)
+{}
+
+int NetworkEvaluator::run()
+{
+    if (!loadEvaluator())
+        return -1;
+
+    ExpectimaxSettings settings;
+    settings.depth = _arguments->searchDepth;
+    settings.probabilityThreshold = _arguments->probabilityThreshold;
+    settings.timeBudget = _arguments->timeBudget;
+    settings.threadCount = _arguments->threadCount;
+    ExpectimaxSearch search(_evaluator.get(), settings);
+
+    playGames(search);
+    return 0;
+}
+
+void NetworkEvaluator::onSigInt()
+{
+    LOG_INFO << "SIGINT caught. Finishing current game...";
+    _sigIntCaught = true;
+}
+
+bool NetworkEvaluator::loadEvaluator()
+{
+    LOG_INFO << "Loading neural network...";
+    try {
+        if (NTupleNetwork::isNTupleNetworkFile(_arguments->networkFileName)) {
+            _evaluator = NTupleNetwork::load(_arguments->networkFileName);
+        } else if (_arguments->fannNetwork) {
+            _fannNetwork = std::make_unique<FANN::neural_net>(_arguments->networkFileName);
+            _evaluator = std::make_unique<FannBoardEvaluator>(_fannNetwork.get());
+        } else {
+            std::ifstream file(_arguments->networkFileName);
+            if (!file.is_open()) {
+                LOG_ERROR << "Neural network loading failed, could not open file " << _arguments->networkFileName;
+                return false;
+            }
+            _network = NeuralNetwork::NetworkSerializer::deserialize(file);
+            _evaluator = std::make_unique<NetworkBoardEvaluator>(_network.get());
+        }
+    } catch (std::runtime_error &exception) {
+        LOG_ERROR << "Neural network loading failed: " << exception.what();
+        return false;
+    }
+    LOG_INFO << "Neural network loaded";
+    return true;
+}
+
+void NetworkEvaluator::playGames(const ExpectimaxSearch &search)
+{
+    Game2048Core::GameCore game(4);
+    unsigned long scoreSum = 0;
+    unsigned long totalMoves = 0;
+    unsigned bestScore = 0;
+    unsigned bestTile = 0;
+    unsigned playedGames = 0;
+    auto evaluationStart = std::chrono::steady_clock::now();
+
+    for (unsigned i = 1; i <= _arguments->gameCount && !_sigIntCaught; ++i) {
+        game.reset();
+        unsigned moves = 0;
+        auto gameStart = std::chrono::steady_clock::now();
+        while (!game.isGameOver()) {
+            auto rankedMoves = search.rankMoves(BoardPacker::pack(game.board()));
+            bool moved = false;
+            for (auto &move: rankedMoves) {
+                if (game.tryMove(move.first)) {
+                    moved = true;
+                    break;
+                }
+            }
+            if (!moved)
+                break;
+            ++moves;
+        }
+        std::chrono::duration<double> gameTime = std::chrono::steady_clock::now() - gameStart;
+
+        unsigned maxTile = 1u << BoardPacker::maxTileExponent(BoardPacker::pack(game.board()));
+        printGameStats(i, game.score(), maxTile, moves, gameTime.count());
+        scoreSum += game.score();
+        totalMoves += moves;
+        bestScore = std::max(bestScore, game.score());
+        bestTile = std::max(bestTile, maxTile);
+        ++playedGames;
+    }
+
+    if (playedGames == 0)
+        return;
+    std::chrono::duration<double> totalTime = std::chrono::steady_clock::now() - evaluationStart;
+    std::cout << "Evaluation finished with stats:" << std::endl;
+    std::cout << "games: " << playedGames
+              << "\taverage score: " << static_cast<double>(scoreSum) / playedGames
+              << "\tbest score: " << bestScore
+              << "\tbest tile: " << bestTile
+              << "\tmoves/s: " << totalMoves / totalTime.count() << std::endl;
+}
+
+void NetworkEvaluator::printGameStats(unsigned game, unsigned score, unsigned maxTile, unsigned moves, double seconds) const
+{
+    std::cout << "[game:\t" << game
+              << "] score:\t" << score
+              << ", max tile:\t" << maxTile
+              << ", moves:\t" << moves
+              << ", moves/s:\t" << moves / seconds << std::endl;
+}
+
+}
@@ -0,0 +1,41 @@
+#ifndef NETWORKEVALUATOR_H
+#define NETWORKEVALUATOR_H
+
+#include "Application.h"
+#include <memory>
+#include <Network.h>
+#include <doublefann.h>
+#include <fann_cpp.h>
+#include "arguments/NetworkEvaluatorArguments.h"
+#include "utils/BoardEvaluator.h"
+#include "utils/ExpectimaxSearch.h"
+
+namespace nn2048
+{
+
+/// Plays games offline with expectimax search driven by given network
+/// and reports scores and search speed.
+class NetworkEvaluator: public Application
+{
+public:
+    NetworkEvaluator(std::unique_ptr<NetworkEvaluatorArguments> arguments);
+
+    int run();
+    void onSigInt();
+
+protected:
+    bool loadEvaluator();
+    void playGames(const ExpectimaxSearch &search);
+    void printGameStats(unsigned game, unsigned score, unsigned maxTile, unsigned moves, double seconds) const;
+
+private:
+    std::unique_ptr<NetworkEvaluatorArguments> _arguments;
+    bool _sigIntCaught;
+    std::unique_ptr<NeuralNetwork::Network> _network;
+    std::unique_ptr<FANN::neural_net> _fannNetwork;
+    std::unique_ptr<BoardEvaluator> _evaluator;
+};
+
+}
+
+#endif // NETWORKEVALUATOR_H
@@ -3,11 +3,25 @@
 #include <fstream>
 #include <boost/filesystem.hpp>
 #include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <numeric>
 #include "utils/BoardSignalConverter.h"
+#include "utils/Logger.h"
+#include "utils/ThreadPool.h"
+#include "utils/RandomService.h"
+#include "utils/BatchOptimizer.h"
+#include "utils/BatchTrainer.h"
+#include "utils/MinibatchPipeline.h"
+#include "utils/MultilayerPerceptron.h"
 
 namespace nn2048
 {
 
+/// More chunks than threads keeps workers busy when file sizes differ
+const unsigned loaderChunksPerThread = 8;
+
 NetworkTeacher::NetworkTeacher(std::unique_ptr<NetworkTeacherArguments> arguments):
     _arguments(std::move(arguments)),
     _sigIntCaught(false)
@@ -15,53 +29,64 @@ NetworkTeacher::NetworkTeacher(std::unique_ptr<NetworkTeacherArguments> argument
 
 int NetworkTeacher::run()
 {
-    std::clog << "Initializing..." << std::endl;
+    LOG_INFO << "Initializing...";
     if (!initialize()) {
-        std::clog << "Initialization failed. Aborting." << std::endl;
+        LOG_ERROR << "Initialization failed. Aborting.";
         return -1;
     }
 
-    std::clog << "Training starts..." << std::endl;
-    std::clog.flush();
-    performTraining();
+    LOG_INFO << "Training starts...";
+    if (_trainingSet) {
+        if (!performBatchTraining()) {
+            LOG_ERROR << "Training failed. Aborting.";
+            return -1;
+        }
+    } else if (_replayStream)
+        performStreamingTraining();
+    else
+        performTraining();
 
-    std::clog << "Training finished. Serializing network... ";
-    std::clog.flush();
+    LOG_INFO << "Training finished. Serializing network...";
     if (!serializeNetwork()) {
-        std::clog << "failed" << std::endl;
+        LOG_ERROR << "Network serialization failed";
         return -1;
     }
-    std::clog << "ok" << std::endl;
+    LOG_INFO << "Network serialized";
     return 0;
 }
 
 void NetworkTeacher::onSigInt()
 {
-    std::clog << "SIGINT caught. Aborting..." << std::endl;
-    std::clog.flush();
+    LOG_INFO << "SIGINT caught. Aborting...";
     _sigIntCaught = true;
 }
 
 bool NetworkTeacher::initialize()
 {
-    std::clog << "Loading neural network..." << std::endl;
-    std::clog.flush();
+    LOG_INFO << "Loading neural network...";
     _network = loadNeuralNetwork();
     if (!_network) {
         return false;
     }
-    std::clog << "Neural network loaded" << std::endl;
+    LOG_INFO << "Neural network loaded";
 
-    std::clog << "Loading replay memory..." << std::endl;
-    std::clog.flush();
+    if (!_arguments->optimizer.empty()) {
+        _trainingSet = createTrainingSet();
+        return _trainingSet != nullptr;
+    } else if (_arguments->streamShards) {
+        _replayStream = createReplayStream();
+        return _replayStream != nullptr;
+    }
+
+    LOG_INFO << "Loading replay memory...";
     _replayMemory = loadReplayMemory();
     if (!_replayMemory) {
         return false;
     } else if (_replayMemory->currentSize() == 0) {
-        std::clog << "Loaded replay memory is empty" << std::endl;
+        LOG_ERROR << "Loaded replay memory is empty";
         return false;
     }
-    std::clog << "Replay memory loaded" << std::endl;
+    LOG_INFO << "Replay memory loaded";
     return true;
 }
 
@@ -70,45 +95,114 @@ std::unique_ptr<FANN::neural_net> NetworkTeacher::loadNeuralNetwork()
     try {
         auto network = std::make_unique<FANN::neural_net>(_arguments->networkFileName);
         if (network->get_num_input() != BoardSignalConverter::numberOfSignalBits) {
-            std::clog << "Neural network has incompatible number of input neurons: " << network->get_num_input() << std::endl;
-            std::clog << "Expected: " << BoardSignalConverter::numberOfSignalBits << std::endl;
+            LOG_ERROR << "Neural network has incompatible number of input neurons: " << network->get_num_input()
+                      << ", expected: " << BoardSignalConverter::numberOfSignalBits;
             return nullptr;
         } else if (network->get_num_output() != 4) {
-            std::clog << "Neural network has incompatible number of output neurons: " << network->get_num_output() << std::endl;
-            std::clog << "Expected: 4" << std::endl;
+            LOG_ERROR << "Neural network has incompatible number of output neurons: " << network->get_num_output()
+                      << ", expected: 4";
             return nullptr;
         }
         return network;
     } catch (...) {
-        std::clog << "Unknown exception caught" << std::endl;
+        LOG_ERROR << "Unknown exception caught";
         return nullptr;
     }
 }
 
 std::unique_ptr<ReplayMemory> NetworkTeacher::loadReplayMemory()
 {
-    auto fileNames = replayMemoryFileNames();
+    auto fileNames = replayMemoryFileNames(".json");
     if (fileNames.empty())
         return nullptr;
 
+    // Files are split into consecutive chunks loaded into local memories on the pool.
+    // Chunks are merged in submission order, so episodes stay in file order.
+    auto loadingStart = std::chrono::steady_clock::now();
+    ThreadPool threadPool(_arguments->threadCount);
+    size_t chunkSize = std::max<size_t>(1, fileNames.size() / (threadPool.threadCount() * loaderChunksPerThread));
+    std::vector<std::future<std::unique_ptr<ReplayMemory>>> chunks;
+    for (size_t first = 0; first < fileNames.size(); first += chunkSize) {
+        auto last = std::min(first + chunkSize, fileNames.size());
+        std::vector<std::string> chunkFileNames(fileNames.begin() + first, fileNames.begin() + last);
+        chunks.push_back(threadPool.submit([this, chunkFileNames] () {
+            return loadReplayFiles(chunkFileNames);
+        }));
+    }
+    LOG_INFO << "Loading " << fileNames.size() << " files on " << threadPool.threadCount() << " threads...";
+
+    auto replayMemory = std::make_unique<ReplayMemory>();
+    size_t loadedFiles = 0;
+    for (auto &future: chunks) {
+        auto chunk = future.get();
+        replayMemory->takeStatesFrom(*chunk);
+        loadedFiles = std::min(loadedFiles + chunkSize, fileNames.size());
+        LOG_INFO << "Loaded " << loadedFiles << " of " << fileNames.size() << " files";
+    }
+    replayMemory->computeReturns(_arguments->gamma, &threadPool);
+
+    std::chrono::duration<double> loadingTime = std::chrono::steady_clock::now() - loadingStart;
+    LOG_INFO << "Loading took " << loadingTime.count() << " s ("
+             << fileNames.size() / loadingTime.count() << " files/s, "
+             << replayMemory->currentSize() / loadingTime.count() << " states/s)";
+    return replayMemory;
+}
+
+std::unique_ptr<ReplayMemory> NetworkTeacher::loadReplayFiles(const std::vector<std::string> &fileNames) const
+{
     auto replayMemory = std::make_unique<ReplayMemory>();
-    auto fileCounter = 1;
     for (auto &fileName: fileNames) {
-        std::clog << "Loading file " << fileCounter << " of " << fileNames.size() << "..." << std::endl;
         try {
             auto gameReplay = std::make_unique<ReplayMemory>(fileName);
-            computeQValues(*gameReplay);
             replayMemory->takeStatesFrom(*gameReplay);
         } catch (std::runtime_error &ex) {
-            std::clog << "Replay memory loading failed: " << fileName << ", exception: " << ex.what() << std::endl;
-            std::clog << "Omitting" << std::endl;
+            LOG_WARNING << "Replay memory loading failed: " << fileName << ", exception: " << ex.what() << ", omitting";
         }
-        ++fileCounter;
     }
     return replayMemory;
 }
 
-std::vector<std::string> NetworkTeacher::replayMemoryFileNames()
+std::unique_ptr<ReplayStream> NetworkTeacher::createReplayStream()
+{
+    auto fileNames = replayMemoryFileNames(".bin");
+    if (fileNames.empty()) {
+        LOG_ERROR << "No replay shards (.bin) found in " << _arguments->replayMemoryDirectory;
+        return nullptr;
+    }
+    LOG_INFO << "Streaming " << fileNames.size() << " replay shards through "
+             << _arguments->shuffleBufferSize << " samples shuffle buffer";
+    return std::make_unique<ReplayStream>(fileNames, _arguments->gamma, _arguments->shuffleBufferSize,
+                                          RandomService::stream("replay-stream"));
+}
+
+std::unique_ptr<TrainingSet> NetworkTeacher::createTrainingSet()
+{
+    std::unique_ptr<TrainingSet> trainingSet;
+    try {
+        if (_arguments->streamShards) {
+            LOG_INFO << "Mapping replay shards...";
+            trainingSet = TrainingSet::fromShards(replayMemoryFileNames(".bin"), _arguments->gamma);
+        } else {
+            LOG_INFO << "Loading replay memory...";
+            auto replayMemory = loadReplayMemory();
+            if (!replayMemory)
+                return nullptr;
+            trainingSet = TrainingSet::fromReplayMemory(*replayMemory);
+        }
+    } catch (std::runtime_error &exception) {
+        LOG_ERROR << "Training set could not be created: " << exception.what();
+        return nullptr;
+    }
+
+    if (trainingSet->size() == 0) {
+        LOG_ERROR << "Training set is empty";
+        return nullptr;
+    }
+    LOG_INFO << "Training set contains " << trainingSet->size() << " samples";
+    return trainingSet;
+}
+
+std::vector<std::string> NetworkTeacher::replayMemoryFileNames(const std::string &extension)
 {
     if (!boost::filesystem::is_directory(_arguments->replayMemoryDirectory)) {
         return {};
@@ -116,60 +210,146 @@ std::vector<std::string> NetworkTeacher::replayMemoryFileNames()
 
     auto fileNames = std::vector<std::string>();
     for (auto &entry: boost::filesystem::directory_iterator(_arguments->replayMemoryDirectory)) {
-        if (entry.path().extension() == ".json")
+        if (entry.path().extension() == extension)
             fileNames.push_back(entry.path().string());
     }
+    // Directory order is unspecified, sorting keeps runs repeatable
+    std::sort(fileNames.begin(), fileNames.end());
     return fileNames;
 }
 
-void NetworkTeacher::computeQValues(const ReplayMemory &replayMemory)
+void NetworkTeacher::performTraining()
 {
-    double prevQValue = 0.0;
-    for (auto it = replayMemory.states().rbegin(); it != replayMemory.states().rend(); ++it) {
-        auto &state = *it;
-        double qvalue = state->receivedReward() + _arguments->gamma * prevQValue;
-        prevQValue = qvalue;
-        _qvalueCache[state.get()] = qvalue;
+    _network->set_learning_rate(static_cast<float>(_arguments->learningRate));
+    _network->set_learning_momentum(static_cast<float>(_arguments->momentum));
+
+    // Next shuffled minibatch is decoded on the pipeline thread while current one trains.
+    // Samples are learned one by one, so full batch only means prefetching in default sized chunks.
+    size_t batchSize = _arguments->batchSize > 0 ? _arguments->batchSize : DefaultOptimizerBatchSize;
+    MinibatchPipeline pipeline(*_replayMemory, batchSize, RandomService::stream("batch-order"));
+
+    for (unsigned epoch = 1; shouldContinueTraining(epoch); ++epoch) {
+        unsigned age = 0;
+        double totalLoss = 0.0;
+
+        bool epochFinished = false;
+        while (!epochFinished && !_sigIntCaught) {
+            auto &batch = pipeline.next();
+            for (size_t i = 0; i < batch.size && !_sigIntCaught; ++i) {
+                totalLoss += trainNetwork(batch.input(i), batch.actions[i], batch.targets[i]);
+                ++age;
+            }
+            epochFinished = batch.lastInEpoch;
+        }
+
+        if (age > 0)
+            printStats(totalLoss, epoch, age);
+        if (minErrorReached(totalLoss, age))
+            break;
     }
+    LOG_INFO << "Minibatch pipeline stalls: " << pipeline.stallCount();
 }
 
-void NetworkTeacher::performTraining()
+void NetworkTeacher::performStreamingTraining()
 {
     _network->set_learning_rate(static_cast<float>(_arguments->learningRate));
     _network->set_learning_momentum(static_cast<float>(_arguments->momentum));
 
-    for (unsigned epoch = 1; epoch <= _arguments->maxEpochs && !_sigIntCaught; ++epoch) {
-        auto trainingBatch = _replayMemory->sampleBatch(static_cast<unsigned int>(_replayMemory->currentSize()));
+    for (unsigned epoch = 1; shouldContinueTraining(epoch); ++epoch) {
+        _replayStream->startEpoch();
         unsigned age = 0;
         double totalLoss = 0.0;
+        TrainingSample sample;
 
-        for (auto &state: trainingBatch) {
-            if (_sigIntCaught)
-                break;
-
-            totalLoss += trainNetwork(state);
+        while (!_sigIntCaught && _replayStream->next(sample)) {
+            auto boardSignal = BoardSignalConverter::packedBoardToBitSignal(sample.board);
+            totalLoss += trainNetwork(boardSignal, sample.action, sample.target);
             ++age;
-            // TODO: report interval from params
-//            if (age % 1000 == 0)
-//                printStats(totalLoss, epoch, age);
         }
 
-        if (age % 1000 != 0)
+        if (age > 0)
             printStats(totalLoss, epoch, age);
+        if (minErrorReached(totalLoss, age))
+            break;
+    }
+}
+
+bool NetworkTeacher::performBatchTraining()
+{
+    std::unique_ptr<MultilayerPerceptron> perceptron;
+    try {
+        perceptron = std::make_unique<MultilayerPerceptron>(MultilayerPerceptron::fromFann(*_network));
+    } catch (std::runtime_error &exception) {
+        LOG_ERROR << "Network cannot be trained with batch optimizer: " << exception.what();
+        return false;
+    }
+
+    auto optimizer = BatchOptimizer::create(_arguments->optimizer, _arguments->learningRate);
+    ThreadPool threadPool(_arguments->threadCount);
+    BatchTrainer trainer(*perceptron, threadPool);
+
+    size_t sampleCount = _trainingSet->size();
+    size_t batchSize = sampleCount;
+    if (!optimizer->needsFullBatch() && _arguments->batchSize > 0)
+        batchSize = std::min<size_t>(_arguments->batchSize, sampleCount);
+
+    // Minibatches are drawn in new random order every epoch, full batch needs no order
+    std::vector<size_t> order;
+    auto orderRandom = RandomService::stream("batch-order");
+    if (batchSize < sampleCount) {
+        order.resize(sampleCount);
+        std::iota(order.begin(), order.end(), 0);
+    }
+
+    std::vector<double> gradient;
+    for (unsigned epoch = 1; shouldContinueTraining(epoch); ++epoch) {
+        std::shuffle(order.begin(), order.end(), orderRandom);
+        double totalLoss = 0.0;
+        for (size_t first = 0; first < sampleCount && !_sigIntCaught; first += batchSize) {
+            auto last = std::min(first + batchSize, sampleCount);
+            totalLoss += trainer.computeGradient(*_trainingSet, order, first, last, gradient);
+            optimizer->step(perceptron->parameters(), gradient);
+        }
+
+        auto age = static_cast<unsigned>(sampleCount);
+        printStats(totalLoss, epoch, age);
+        if (minErrorReached(totalLoss, age))
+            break;
     }
+    perceptron->toFann(*_network);
+    return true;
+}
+
+bool NetworkTeacher::shouldContinueTraining(unsigned epoch) const
+{
+    if (_sigIntCaught)
+        return false;
+    return _arguments->maxEpochs == 0 || epoch <= _arguments->maxEpochs;
+}
+
+bool NetworkTeacher::minErrorReached(double totalLoss, unsigned age) const
+{
+    if (_arguments->minError <= 0.0 || age == 0 || totalLoss / age > _arguments->minError)
+        return false;
+    LOG_INFO << "Minimum error reached";
+    return true;
+}
+
+double NetworkTeacher::trainNetwork(const std::vector<double> &boardSignal, Game2048Core::Direction action, double targetValue)
+{
+    return trainNetwork(&boardSignal[0], action, targetValue);
 }
 
-double NetworkTeacher::trainNetwork(const QLearningState *state)
+double NetworkTeacher::trainNetwork(const double *boardSignal, Game2048Core::Direction action, double targetValue)
 {
     double loss = 0.0;
-    auto inputs = const_cast<double *>(&(state->boardSignal()[0]));
+    auto inputs = const_cast<double *>(boardSignal);
     double outputs[4];
-    double targetValue = _qvalueCache.at(state);
 
     auto response = _network->run(inputs);
     for (unsigned long i = 0; i < sizeof(outputs) / sizeof(outputs[0]); ++i)
         outputs[i] = response[i];
-    if (state->takenAction() == Game2048Core::Direction::None) {
+    if (action == Game2048Core::Direction::None) {
         for (unsigned long i = 0; i < sizeof(outputs) / sizeof(outputs[0]); ++i) {
             double currentLoss = outputs[i] - targetValue;
             loss += currentLoss * currentLoss;
@@ -177,7 +357,7 @@ double NetworkTeacher::trainNetwork(const QLearningState *state)
         }
         loss /= sizeof(outputs) / sizeof(outputs[0]);
     } else {
-        auto targetNeuron = static_cast<unsigned>(state->takenAction());
+        auto targetNeuron = static_cast<unsigned>(action);
         loss = outputs[targetNeuron] - targetValue;
         loss *= loss;
         outputs[targetNeuron] = targetValue;
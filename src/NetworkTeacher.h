@@ -3,12 +3,13 @@
 
 #include "Application.h"
 #include <memory>
-#include <map>
 #include <vector>
 #include <doublefann.h>
 #include <fann_cpp.h>
 #include "arguments/NetworkTeacherArguments.h"
 #include "utils/ReplayMemory.h"
+#include "utils/ReplayStream.h"
+#include "utils/TrainingSet.h"
 
 namespace nn2048
 {
@@ -25,10 +26,19 @@ protected:
     bool initialize();
     std::unique_ptr<FANN::neural_net> loadNeuralNetwork();
     std::unique_ptr<ReplayMemory> loadReplayMemory();
-    std::vector<std::string> replayMemoryFileNames();
-    void computeQValues(const ReplayMemory &replayMemory);
+    std::unique_ptr<ReplayStream> createReplayStream();
+    std::unique_ptr<TrainingSet> createTrainingSet();
+    std::vector<std::string> replayMemoryFileNames(const std::string &extension);
+    /// Loads consecutive files into one memory, failed files are omitted
+    std::unique_ptr<ReplayMemory> loadReplayFiles(const std::vector<std::string> &fileNames) const;
     void performTraining();
-    double trainNetwork(const QLearningState *state);
+    void performStreamingTraining();
+    bool performBatchTraining();
+    bool shouldContinueTraining(unsigned epoch) const;
+    /// Returns true when average loss reached minimum error
+    bool minErrorReached(double totalLoss, unsigned age) const;
+    double trainNetwork(const std::vector<double> &boardSignal, Game2048Core::Direction action, double targetValue);
+    double trainNetwork(const double *boardSignal, Game2048Core::Direction action, double targetValue);
     void printStats(double totalLoss, unsigned epoch, unsigned age);
     bool serializeNetwork();
 
@@ -37,7 +47,8 @@ private:
     bool _sigIntCaught;
     std::unique_ptr<FANN::neural_net> _network;
     std::unique_ptr<ReplayMemory> _replayMemory;
-    std::map<const QLearningState *, double> _qvalueCache;
+    std::unique_ptr<ReplayStream> _replayStream;
+    std::unique_ptr<TrainingSet> _trainingSet;
 };
 
 }
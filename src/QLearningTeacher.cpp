@@ -6,11 +6,16 @@
 #include <iostream>
 #include <stdexcept>
 #include <boost/filesystem.hpp>
-#include <random>
 #include "utils/BoardSignalConverter.h"
+#include "utils/Logger.h"
 #include "utils/NetworkOutputConverter.h"
 #include "utils/ReplayMemory.h"
+#include "utils/ReplayReader.h"
+#include "utils/ReplayReservoir.h"
 #include "utils/Reinforcement.h"
+#include "utils/BoardPacker.h"
+#include "utils/FannBoardEvaluator.h"
+#include "utils/RandomService.h"
 
 namespace nn2048
 {
@@ -30,25 +35,32 @@ int QLearningTeacher::run()
         _network = loadNeuralNetwork();
     else
     {
-        std::cout << "Neural network not found.";
+        LOG_ERROR << "Neural network not found: " << _arguments->networkFileName;
         return -1;
     }
     if (!_network)
         return -1;
 
-    if (_arguments->replayMemoryFileName.empty() == false) {
-        auto replayMemory = loadReplayMemory();
-        if (!replayMemory)
+    if (_arguments->afterstateLearning) {
+        if (_network->get_num_output() != 1) {
+            LOG_ERROR << "Afterstate learning requires network with a single output";
             return -1;
-        else if (replayMemory->currentSize() > _arguments->replayMemorySize) {
-            std::cout << "Replay memory size (" << replayMemory->currentSize() << ") is greater than max replay memory size ";
-            std::cout << "(" << _arguments->replayMemorySize << ")" << std::endl;
-            std::cout << "Replay memory will contain only game states up to max size" << std::endl;
         }
-        _replayMemory->takeStatesFrom(*replayMemory);
+        if (!FannBoardEvaluator::isSupportedInputCount(_network->get_num_input())) {
+            LOG_ERROR << "Afterstate learning requires network with " << BoardSignalConverter::numberOfTiles
+                      << " or " << BoardSignalConverter::numberOfSignalBits << " inputs";
+            return -1;
+        }
+        LOG_INFO << "Afterstate learning starts...";
+        performAfterstateLearning();
+        serializeNetwork();
+        return 0;
     }
 
-    std::cout << "Learning starts..." << std::endl;
+    if (_arguments->replayMemoryFileName.empty() == false && !loadReplayMemory())
+        return -1;
+
+    LOG_INFO << "Learning starts...";
     performLearning();
     serializeNetwork();
     return 0;
@@ -63,37 +75,47 @@ std::unique_ptr<FANN::neural_net> QLearningTeacher::loadNeuralNetwork() const
 {
     try
     {
-        std::cout << "Loading neural network... ";
-        std::cout.flush();
+        LOG_INFO << "Loading neural network...";
 
         auto network = std::make_unique<FANN::neural_net>(_arguments->networkFileName);
 
-        std::cout << "ok" << std::endl;
+        LOG_INFO << "Neural network loaded";
         return network;
     }
     catch (std::runtime_error &exception)
     {
-        std::cout << "failed" << std::endl;
-        std::cerr << "Runtime exception: " << exception.what() << std::endl;
+        LOG_ERROR << "Neural network loading failed: " << exception.what();
     }
     return nullptr;
 }
 
-std::unique_ptr<ReplayMemory> QLearningTeacher::loadReplayMemory() const
+bool QLearningTeacher::loadReplayMemory()
 {
+    // States beyond memory size are not dropped from the end, the memory
+    // gets a uniform sample of the whole file read in one pass
+    ReplayReservoir reservoir(_arguments->replayMemorySize, RandomService::stream("replay-reservoir"));
     try {
-        std::cout << "Loading replay memory... ";
-        std::cout.flush();
+        LOG_INFO << "Loading replay memory...";
 
-        auto replayMemory = std::make_unique<ReplayMemory>(_arguments->replayMemoryFileName);
+        auto reader = ReplayReader::open(_arguments->replayMemoryFileName);
+        std::unique_ptr<QLearningState> state;
+        while (reader->next(state))
+            reservoir.offer(std::move(state));
 
-        std::cout << "ok" << std::endl;
-        return replayMemory;
+        LOG_INFO << "Replay memory loaded";
     } catch (std::exception &ex) {
-        std::cout << "failed" << std::endl;
-        std::cerr << "Couldn't load replay memory. Exception thrown: " << ex.what() << std::endl;
+        LOG_ERROR << "Couldn't load replay memory. Exception thrown: " << ex.what();
+        return false;
     }
-    return nullptr;
+
+    if (reservoir.offeredCount() > reservoir.size()) {
+        LOG_INFO << "Replay memory size (" << reservoir.offeredCount() << ") is greater than max replay memory size "
+                 << "(" << _arguments->replayMemorySize << ")";
+        LOG_INFO << "Replay memory will contain uniform sample of " << reservoir.size() << " game states";
+    }
+    for (auto &state: reservoir.takeStates())
+        _replayMemory->addState(std::move(state));
+    return true;
 }
 
 void QLearningTeacher::performLearning() const
@@ -110,8 +132,7 @@ void QLearningTeacher::performLearning() const
     _network->set_learning_rate(static_cast<float>(_arguments->learningRate));
     _network->set_learning_momentum(static_cast<float>(_arguments->momentumFactor));
 
-    std::default_random_engine randomEngine;
-    std::uniform_real_distribution<double> randomDistrib(0, 1);
+    auto actorRandom = RandomService::stream("actor");
 
     while (shouldContinueLearning() && !_sigIntCaught)
     {
@@ -130,10 +151,10 @@ void QLearningTeacher::performLearning() const
 
         // Pick action
         Game2048Core::Direction pickedDirection;
-        if (randomDistrib(randomEngine) <= _arguments->epsilonFactor) {
+        if (actorRandom.nextDouble() <= _arguments->epsilonFactor) {
             // Random
-            int totalDirections = static_cast<unsigned>(Game2048Core::Direction::Total);
-            pickedDirection = static_cast<Game2048Core::Direction>(rand() % totalDirections);
+            unsigned totalDirections = static_cast<unsigned>(Game2048Core::Direction::Total);
+            pickedDirection = static_cast<Game2048Core::Direction>(actorRandom.nextIndex(totalDirections));
         }
         else {
             // Best
@@ -170,10 +191,105 @@ void QLearningTeacher::performLearning() const
         prevMoveFailed = moveFailed;
         prevDirection = pickedDirection;
     }
-    std::cout << "Learning finished with stats: " << std::endl;
+    std::cout << "Learning finished with stats:" << std::endl;
     printStats(age, _game->score(), agentStepCount, illegalMoves, lossSum / age, currentLossSum / agentStepCount);
 }
 
+void QLearningTeacher::performAfterstateLearning() const
+{
+    const unsigned totalDirections = static_cast<unsigned>(Game2048Core::Direction::Total);
+    unsigned age = 0;
+    unsigned agentStepCount = 0;
+    double lossSum = 0;
+    double currentLossSum = 0;
+    bool hasPrevAfterstate = false;
+    std::vector<double> prevAfterstateSignal;
+    auto shouldContinueLearning = learningCondition(age, _game->state().score);
+
+    _network->set_learning_rate(static_cast<float>(_arguments->learningRate));
+    _network->set_learning_momentum(static_cast<float>(_arguments->momentumFactor));
+
+    FannBoardEvaluator evaluator(_network.get());
+    auto actorRandom = RandomService::stream("actor");
+
+    // Trains previous afterstate towards target, returns squared error loss
+    auto trainPrevAfterstate = [&] (double prevValue, double target) -> double {
+        double output = target;
+        _network->train(&prevAfterstateSignal[0], &output);
+        double loss = target - prevValue;
+        return 0.5 * loss * loss;
+    };
+
+    double prevAfterstateValue = 0.0;
+    while (shouldContinueLearning() && !_sigIntCaught)
+    {
+        if (_game->isGameOver())
+        {
+            // Game ended after the spawn that followed previous afterstate
+            if (hasPrevAfterstate) {
+                double loss = trainPrevAfterstate(prevAfterstateValue, Reinforcement::computeReinforcement(true, true, 0, 0));
+                lossSum += loss;
+                currentLossSum += loss;
+            }
+            printStats(age, _game->score(), agentStepCount, 0, lossSum / age, currentLossSum / agentStepCount);
+            _game->reset();
+            hasPrevAfterstate = false;
+            agentStepCount = 0;
+            currentLossSum = 0;
+            continue;
+        }
+        else if (agentStepCount > 0 && agentStepCount % 1000 == 0)
+            printStats(age, _game->score(), agentStepCount, 0, lossSum / age, currentLossSum / agentStepCount);
+
+        // All legal afterstates are valued in one pass, chosen one is reused as TD target
+        auto board = BoardPacker::pack(_game->board());
+        std::vector<Game2048Core::Direction> directions;
+        std::vector<PackedBoard> afterstates;
+        std::vector<double> reinforcements;
+        for (unsigned i = 0; i < totalDirections; ++i) {
+            unsigned reward;
+            auto direction = static_cast<Game2048Core::Direction>(i);
+            auto afterstate = BoardPacker::move(board, direction, reward);
+            if (afterstate == board)
+                continue;
+            directions.push_back(direction);
+            afterstates.push_back(afterstate);
+            reinforcements.push_back(Reinforcement::computeReinforcement(false, true, _game->score() + reward, _game->score()));
+        }
+        std::vector<double> values;
+        evaluator.evaluate(afterstates, values);
+
+        size_t picked = 0;
+        if (actorRandom.nextDouble() <= _arguments->epsilonFactor) {
+            picked = static_cast<size_t>(actorRandom.nextIndex(afterstates.size()));
+        } else {
+            for (size_t i = 1; i < afterstates.size(); ++i)
+                if (reinforcements[i] + _arguments->gamma * values[i] > reinforcements[picked] + _arguments->gamma * values[picked])
+                    picked = i;
+        }
+
+        if (hasPrevAfterstate) {
+            double target = reinforcements[picked] + _arguments->gamma * values[picked];
+            double loss = trainPrevAfterstate(prevAfterstateValue, target);
+            lossSum += loss;
+            currentLossSum += loss;
+        }
+
+        if (!_game->tryMove(directions[picked])) {
+            LOG_ERROR << "Picked move was rejected by game core. Aborting";
+            break;
+        }
+        prevAfterstateSignal = evaluator.encode(afterstates[picked]);
+        prevAfterstateValue = values[picked];
+        hasPrevAfterstate = true;
+
+        ++age;
+        ++agentStepCount;
+    }
+    std::cout << "Learning finished with stats:" << std::endl;
+    printStats(age, _game->score(), agentStepCount, 0, lossSum / age, currentLossSum / agentStepCount);
+}
+
 double QLearningTeacher::trainNetwork(const std::vector<const QLearningState *> &batch) const
 {
     const unsigned outputCount = static_cast<unsigned>(Game2048Core::Direction::Total);
@@ -223,9 +339,9 @@ double QLearningTeacher::trainNetwork(const std::vector<const QLearningState *>
 
 void QLearningTeacher::serializeNetwork() const
 {
-    std::cout << "Serializing network... ";
+    LOG_INFO << "Serializing network...";
     _network->save(_arguments->networkFileName);
-    std::cout << "ok" << std::endl;
+    LOG_INFO << "Network serialized";
 }
 
 std::function<bool()> QLearningTeacher::learningCondition(const unsigned &age, const unsigned &score) const
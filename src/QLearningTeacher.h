@@ -30,8 +30,10 @@ public:
 
 protected:
     std::unique_ptr<FANN::neural_net> loadNeuralNetwork() const;
-    std::unique_ptr<ReplayMemory> loadReplayMemory() const;
+    /// Fills replay memory from the initial replay file
+    bool loadReplayMemory();
     void performLearning() const;
+    void performAfterstateLearning() const;
     double trainNetwork(const std::vector<const QLearningState *> &batch) const;
     void serializeNetwork() const;
     std::function<bool()> learningCondition(const unsigned &age, const unsigned &score) const;
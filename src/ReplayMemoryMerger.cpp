@@ -1,80 +1,323 @@
 #include "ReplayMemoryMerger.h"
-#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <map>
 #include <boost/filesystem.hpp>
+#include "utils/Logger.h"
+#include "utils/RandomService.h"
+#include "utils/ReplayReader.h"
+#include "utils/ReplayRecorder.h"
+#include "utils/ThreadPool.h"
 
 namespace nn2048 {
 
+namespace
+{
+
+/// Decoded files waiting to be written, per pool thread
+const unsigned pendingFilesPerThread = 2;
+
+}
+
 ReplayMemoryMerger::ReplayMemoryMerger(std::unique_ptr<ReplayMemoryMergerArguments> arguments) :
     _arguments(std::move(arguments))
 { }
 
 int ReplayMemoryMerger::run()
 {
-    auto jsons = scanForJsons();
-    if (jsons.empty()) {
-        std::clog << "No json files found. Aborting" << std::endl;
+    auto replayFiles = scanForReplayFiles();
+    if (replayFiles.empty()) {
+        LOG_ERROR << "No replay files (.json, .nnrz) found. Aborting";
         return -1;
     }
 
-    auto replayMemory = loadReplayMemory(jsons);
-    if (!replayMemory)
-        return -1;
-    else {
-        std::clog << replayMemory->currentSize() << " game states loaded" << std::endl;
+    // Deduplicated and sampled outputs cannot be extended, their state is not stored
+    auto manifestFileName = MergeManifest::fileNameFor(_arguments->outputFileName);
+    bool append = !_arguments->deduplicate && _arguments->maxSize == 0 && loadManifest(manifestFileName);
+    auto newFiles = append ? selectNewFiles(replayFiles) : replayFiles;
+    if (append && newFiles.empty()) {
+        LOG_INFO << "No new replay files since the last merge";
+        return 0;
     }
 
-    if (!serializeReplayMemory(*replayMemory))
+    std::unique_ptr<ReplayWriter> writer;
+    try {
+        writer = createWriter(append);
+        // Output was extended by a merge which did not get to save the manifest
+        if (append && writer->stateCount() != _manifest.outputStateCount()) {
+            LOG_WARNING << "Output has " << writer->stateCount() << " game states, manifest records "
+                        << _manifest.outputStateCount() << ", output is rebuilt";
+            writer.reset();
+            _manifest = MergeManifest();
+            append = false;
+            newFiles = replayFiles;
+            writer = createWriter(append);
+        }
+    } catch (std::runtime_error &ex) {
+        LOG_ERROR << "Replay memory writing failed: " << ex.what();
+        if (append)
+            LOG_INFO << "Remove " << manifestFileName << " to rebuild the output";
         return -1;
+    }
+
+    if (_arguments->deduplicate)
+        _deduplicator = std::make_unique<ReplayDeduplicator>(_arguments->reduceSymmetries);
+    if (_arguments->maxSize > 0)
+        _reservoir = std::make_unique<ReplayReservoir>(_arguments->maxSize, RandomService::stream("merge-reservoir"), false);
+    auto mergedCount = writer->stateCount();
+    mergeReplayFiles(newFiles, *writer);
+    _manifest.setOutputStateCount(writer->stateCount());
 
+    LOG_INFO << "Finishing replay memory file...";
+    if (!writer->close()) {
+        LOG_ERROR << "Replay memory file could not be finished";
+        return -1;
+    }
+    // Saved right after the output, state count reveals a merge interrupted in between
+    if (!_manifest.save(manifestFileName)) {
+        LOG_ERROR << "Manifest could not be saved: " << manifestFileName;
+        return -1;
+    }
+    LOG_INFO << "Finished, " << writer->stateCount() - mergedCount << " game states merged, "
+             << writer->stateCount() << " in total";
     return 0;
 }
 
-std::vector<std::string> ReplayMemoryMerger::scanForJsons() const
+bool ReplayMemoryMerger::loadManifest(const std::string &manifestFileName)
+{
+    // Sharded output exists when its index was written
+    auto outputFileName = _arguments->shardCount > 1
+            ? ShardedReplayWriter::indexFileNameFor(_arguments->outputFileName)
+            : _arguments->outputFileName;
+    if (!boost::filesystem::exists(outputFileName) || !boost::filesystem::exists(manifestFileName))
+        return false;
+    try {
+        _manifest.load(manifestFileName);
+    } catch (std::exception &ex) {
+        LOG_WARNING << "Manifest ignored, output is rebuilt: " << ex.what();
+        _manifest = MergeManifest();
+        return false;
+    }
+    LOG_INFO << _manifest.size() << " files were merged before, appending new ones";
+    return true;
+}
+
+std::vector<std::string> ReplayMemoryMerger::selectNewFiles(const std::vector<std::string> &fileNames) const
+{
+    std::vector<std::string> newFileNames;
+    for (auto &fileName: fileNames) {
+        ManifestEntry entry;
+        try {
+            entry = MergeManifest::describe(fileName);
+        } catch (std::exception &ex) {
+            LOG_WARNING << "Replay file omitted: " << ex.what();
+            continue;
+        }
+        if (_manifest.contains(entry))
+            continue;
+        if (_manifest.containsName(entry.name)) {
+            // States of the old version are already in the output and cannot be replaced
+            LOG_WARNING << fileName << " changed since it was merged, omitting";
+            continue;
+        }
+        newFileNames.push_back(fileName);
+    }
+    return newFileNames;
+}
+
+std::set<std::uintmax_t> ReplayMemoryMerger::findSharedSizes(const std::vector<std::string> &fileNames)
+{
+    std::map<std::uintmax_t, unsigned> sizeCounts;
+    for (auto &item: _manifest.entries())
+        ++sizeCounts[item.second.size];
+    for (auto &fileName: fileNames) {
+        try {
+            ++sizeCounts[boost::filesystem::file_size(fileName)];
+        } catch (boost::filesystem::filesystem_error &) {
+            // Reported when the file is decoded
+        }
+    }
+
+    std::set<std::uintmax_t> sharedSizes;
+    for (auto &sizeCount: sizeCounts) {
+        if (sizeCount.second > 1)
+            sharedSizes.insert(sizeCount.first);
+    }
+
+    std::vector<ManifestEntry> unhashedEntries;
+    for (auto &item: _manifest.entries()) {
+        if (item.second.hash.empty() && sharedSizes.count(item.second.size) == 1)
+            unhashedEntries.push_back(item.second);
+    }
+    for (auto &entry: unhashedEntries) {
+        auto fileName = (boost::filesystem::path(_arguments->inputDirectory) / entry.name).string();
+        try {
+            // Hash of a file changed since its merge would not describe the merged content
+            if (!_manifest.contains(MergeManifest::describe(fileName)))
+                continue;
+            auto hashedEntry = entry;
+            hashedEntry.hash = MergeManifest::hashFile(fileName);
+            _manifest.add(hashedEntry);
+        } catch (std::exception &) {
+            // Merged file was removed, its copies cannot be recognized
+        }
+    }
+    return sharedSizes;
+}
+
+std::unique_ptr<ReplayWriter> ReplayMemoryMerger::createWriter(bool append) const
+{
+    if (_arguments->shardCount > 1)
+        return std::make_unique<ShardedReplayWriter>(_arguments->outputFileName, _arguments->shardCount, append);
+    return ReplayWriter::create(_arguments->outputFileName, append);
+}
+
+std::vector<std::string> ReplayMemoryMerger::scanForReplayFiles() const
 {
     if (!boost::filesystem::is_directory(_arguments->inputDirectory)) {
-        std::clog << _arguments->inputDirectory << " is not a directory" << std::endl;
+        LOG_ERROR << _arguments->inputDirectory << " is not a directory";
         return {};
     }
 
     auto fileNames = std::vector<std::string>();
     for (auto &entry: boost::filesystem::directory_iterator(_arguments->inputDirectory)) {
-        if (entry.path().extension() == ".json")
+        // Recorder files still being written end with .part and are left for later
+        auto extension = entry.path().extension();
+        if (extension == ".json" || extension == ".nnrz")
             fileNames.push_back(entry.path().string());
     }
+    // Directory order is unspecified, sorting keeps output repeatable
+    std::sort(fileNames.begin(), fileNames.end());
     return fileNames;
 }
 
-std::unique_ptr<ReplayMemory> ReplayMemoryMerger::loadReplayMemory(const std::vector<std::string> &fileNames) const
+void ReplayMemoryMerger::mergeReplayFiles(const std::vector<std::string> &fileNames, ReplayWriter &writer)
 {
-    auto replayMemory = std::make_unique<ReplayMemory>();
-    auto fileCounter = 1;
-    for (auto &fileName: fileNames) {
-        std::clog << "Loading file " << fileCounter << " of " << fileNames.size() << "...\r";
+    auto mergeStart = std::chrono::steady_clock::now();
+    ThreadPool threadPool(_arguments->threadCount);
+    size_t windowSize = threadPool.threadCount() * pendingFilesPerThread;
+    std::deque<std::future<DecodedFile>> pending;
+    size_t nextFile = 0;
+    auto sharedSizes = findSharedSizes(fileNames);
+
+    for (size_t fileIndex = 0; fileIndex < fileNames.size(); ++fileIndex) {
+        for (; nextFile < fileNames.size() && pending.size() < windowSize; ++nextFile) {
+            auto fileName = fileNames[nextFile];
+            bool computeReturns = _deduplicator || _reservoir;
+            double gamma = _arguments->gamma;
+            pending.push_back(threadPool.submit([fileName, computeReturns, gamma, &sharedSizes] () {
+                DecodedFile decoded;
+                decoded.manifestEntry = MergeManifest::describe(fileName);
+                if (sharedSizes.count(decoded.manifestEntry.size) == 1)
+                    decoded.manifestEntry.hash = MergeManifest::hashFile(fileName);
+                decoded.replayMemory = loadReplayFile(fileName);
+                // Deduplicated samples keep mean return, so it is computed while episodes are known
+                if (computeReturns)
+                    decoded.replayMemory->computeReturns(gamma);
+                return decoded;
+            }));
+        }
+
+        LOG_DEBUG << "Merging file " << fileIndex + 1 << " of " << fileNames.size() << "...";
+        auto future = std::move(pending.front());
+        pending.pop_front();
         try {
-            auto gameReplay = std::make_unique<ReplayMemory>(fileName);
-            replayMemory->takeStatesFrom(*gameReplay);
-        } catch (std::runtime_error &ex) {
-            std::clog << std::endl;
-            std::clog << "Replay memory loading failed: " << fileName << ", exception: " << ex.what() << std::endl;
-            std::clog << "Omitting" << std::endl;
+            auto decoded = future.get();
+            if (!decoded.manifestEntry.hash.empty() && _manifest.containsHash(decoded.manifestEntry.hash)) {
+                LOG_WARNING << fileNames[fileIndex] << " is a copy of a merged file, omitting";
+                continue;
+            }
+            if (_deduplicator)
+                deduplicateReplayMemory(*decoded.replayMemory);
+            else if (_reservoir)
+                sampleReplayMemory(*decoded.replayMemory);
+            else
+                writeReplayMemory(*decoded.replayMemory, decoded.manifestEntry.name, writer);
+            // Failed files stay out of the manifest, so they are retried next time
+            _manifest.add(decoded.manifestEntry);
+        } catch (std::exception &ex) {
+            LOG_WARNING << "Replay memory loading failed: " << fileNames[fileIndex] << ", exception: " << ex.what() << ", omitting";
         }
-        ++fileCounter;
     }
-    std::clog << std::endl;
+    LOG_INFO << fileNames.size() << " files processed";
+
+    if (_deduplicator) {
+        std::chrono::duration<double> mergeTime = std::chrono::steady_clock::now() - mergeStart;
+        auto inputCount = _deduplicator->inputCount();
+        auto uniqueCount = _deduplicator->uniqueCount();
+        double ratio = uniqueCount > 0 ? static_cast<double>(inputCount) / uniqueCount : 0.0;
+        LOG_INFO << inputCount << " game states deduplicated into " << uniqueCount << " unique samples"
+                 << ", ratio " << ratio << ":1"
+                 << ", " << inputCount / std::max(mergeTime.count(), 1e-9) << " states/s";
+        writeDeduplicated(writer);
+    } else if (_reservoir) {
+        LOG_INFO << _reservoir->size() << " of " << _reservoir->offeredCount() << " game states sampled";
+        writeSampled(writer);
+    }
+}
+
+std::unique_ptr<ReplayMemory> ReplayMemoryMerger::loadReplayFile(const std::string &fileName)
+{
+    if (!ReplayRecorder::isRecordingFile(fileName))
+        return std::make_unique<ReplayMemory>(fileName);
+
+    // Recorder files hold many games, their episode ends are stored with the states
+    auto replayMemory = std::make_unique<ReplayMemory>();
+    auto reader = ReplayReader::open(fileName);
+    std::unique_ptr<QLearningState> state;
+    while (reader->next(state))
+        replayMemory->addState(std::move(state));
     return replayMemory;
 }
 
-bool ReplayMemoryMerger::serializeReplayMemory(const ReplayMemory &replayMemory)
+void ReplayMemoryMerger::writeReplayMemory(const ReplayMemory &replayMemory, const std::string &sourceName,
+                                           ReplayWriter &writer)
 {
-    std::clog << "Serializing replay memory..." << std::endl;
-    std::clog.flush();
-    if (!replayMemory.serialize(_arguments->outputFileName)) {
-        std::clog << "Failed" << std::endl;
-        return false;
-    } else {
-        std::clog << "Finished" << std::endl;
-        return true;
+    // Every input file is a complete game, its last state ends the episode
+    auto &states = replayMemory.states();
+    unsigned episode = 0;
+    bool episodeStart = true;
+    for (size_t i = 0; i < states.size(); ++i) {
+        if (episodeStart)
+            writer.beginEpisode(sourceName + "#" + std::to_string(episode++));
+        auto &state = *states[i];
+        bool episodeEnd = state.isEpisodeEnd() || state.isInTerminalState() || i + 1 == states.size();
+        writer.write(state, episodeEnd);
+        episodeStart = episodeEnd;
     }
 }
 
+void ReplayMemoryMerger::deduplicateReplayMemory(const ReplayMemory &replayMemory)
+{
+    for (auto &state: replayMemory.states())
+        _deduplicator->add(*state);
+}
+
+void ReplayMemoryMerger::sampleReplayMemory(ReplayMemory &replayMemory)
+{
+    for (auto &state: replayMemory.releaseStates())
+        _reservoir->offer(std::move(state));
+}
+
+void ReplayMemoryMerger::writeSampled(ReplayWriter &writer)
+{
+    // Sampled states lose their episodes, so like deduplicated samples they
+    // are written as single state episodes rewarded with their return
+    LOG_INFO << "Writing sampled states...";
+    for (auto &state: _reservoir->takeStates()) {
+        auto record = ReplayRecord::fromState(*state);
+        record.reward = static_cast<float>(state->discountedReturn());
+        record.flags |= EpisodeEndRecordFlag;
+        writer.writeRecord(record);
+    }
+}
+
+void ReplayMemoryMerger::writeDeduplicated(ReplayWriter &writer)
+{
+    LOG_INFO << "Writing unique samples...";
+    _deduplicator->writeTo(writer);
+}
+
 }
@@ -2,9 +2,14 @@
 #define REPLAYMEMORYMERGER_H
 
 #include "Application.h"
+#include <set>
 #include <vector>
 #include "arguments/ReplayMemoryMergerArguments.h"
+#include "utils/MergeManifest.h"
+#include "utils/ReplayDeduplicator.h"
 #include "utils/ReplayMemory.h"
+#include "utils/ReplayReservoir.h"
+#include "utils/ReplayWriter.h"
 
 namespace nn2048 {
 
@@ -16,12 +21,42 @@ public:
     int run();
 
 protected:
-    std::vector<std::string> scanForJsons() const;
-    std::unique_ptr<ReplayMemory> loadReplayMemory(const std::vector<std::string> &fileNames) const;
-    bool serializeReplayMemory(const ReplayMemory &replayMemory);
+    struct DecodedFile
+    {
+        std::unique_ptr<ReplayMemory> replayMemory;
+        ManifestEntry manifestEntry;
+    };
+
+    /// Json replay files and finished recorder files of the input directory
+    std::vector<std::string> scanForReplayFiles() const;
+    /// Returns true when output and its manifest exist, so new files can be appended
+    bool loadManifest(const std::string &manifestFileName);
+    /// Files not listed in the manifest, changed files are reported and omitted
+    std::vector<std::string> selectNewFiles(const std::vector<std::string> &fileNames) const;
+    /// Sizes shared by more than one input or manifest file. Only such files can
+    /// be copies, so only they are hashed. Merged files of these sizes get
+    /// their missing hashes from the input directory.
+    std::set<std::uintmax_t> findSharedSizes(const std::vector<std::string> &fileNames);
+    /// Throws std::runtime_error when output cannot be created or continued
+    std::unique_ptr<ReplayWriter> createWriter(bool append) const;
+    /// Decodes input files on a thread pool and writes them in file order.
+    /// Only a bounded window of decoded files is kept in memory.
+    void mergeReplayFiles(const std::vector<std::string> &fileNames, ReplayWriter &writer);
+    /// Throws std::runtime_error when file cannot be decoded
+    static std::unique_ptr<ReplayMemory> loadReplayFile(const std::string &fileName);
+    /// Episodes are identified by source file name and their order in the file
+    static void writeReplayMemory(const ReplayMemory &replayMemory, const std::string &sourceName,
+                                  ReplayWriter &writer);
+    void deduplicateReplayMemory(const ReplayMemory &replayMemory);
+    void writeDeduplicated(ReplayWriter &writer);
+    void sampleReplayMemory(ReplayMemory &replayMemory);
+    void writeSampled(ReplayWriter &writer);
 
 private:
     std::unique_ptr<ReplayMemoryMergerArguments> _arguments;
+    std::unique_ptr<ReplayDeduplicator> _deduplicator;
+    std::unique_ptr<ReplayReservoir> _reservoir;
+    MergeManifest _manifest;
 };
 
 }
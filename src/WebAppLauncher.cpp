@@ -1,7 +1,6 @@
 #include "WebAppLauncher.h"
-#include <iostream>
-#include <fstream>
-#include <NetworkSerializer.h>
+#include <chrono>
+#include "utils/Logger.h"
 #include "web/WebApplication.h"
 
 namespace nn2048
@@ -16,21 +15,49 @@ int WebAppLauncher::run()
     try
     {
         loadNeuralNetwork();
+        if (_evaluator)
+            _inferenceService = std::make_unique<InferenceService>(_evaluator.get(),
+                                                                   std::chrono::microseconds(_arguments->inferenceLatency),
+                                                                   _arguments->inferenceThreadCount,
+                                                                   DefaultInferenceBatchSize);
+        if (_evaluator)
+            _spectatorChannel = std::make_unique<SpectatorChannel>(_evaluator.get(),
+                                                                   std::chrono::milliseconds(_arguments->spectatorMoveInterval));
+        _replayRecorder = std::make_unique<ReplayRecorder>(_arguments->appRootDirectory);
+        _moveScheduler = std::make_unique<TimerWheel>();
+        if (_evaluator && _arguments->searchThreadCount > 1)
+            _searchThreadPool = std::make_unique<ThreadPool>();
+        _metrics = std::make_unique<WebAppMetrics>();
+        _metricsResource = std::make_unique<MetricsResource>(_metrics.get(), _inferenceService.get(), _replayRecorder.get(),
+                                                             _spectatorChannel.get(), _moveScheduler.get());
         setupServer();
         if (_server->start())
         {
             _server->waitForShutdown();
             _server->stop();
+            _spectatorChannel.reset();
+            if (_inferenceService)
+                LOG_INFO << "Inference: " << _inferenceService->requestCount() << " requests in "
+                         << _inferenceService->batchCount() << " batches";
+            auto recorded = _replayRecorder->statistics();
+            LOG_INFO << "Recorded games: " << recorded.writtenGames << " written, " << recorded.droppedGames
+                     << " dropped, queue peak " << recorded.maxQueueDepth << "/" << recorded.queueCapacity
+                     << ", " << recorded.rawBytes << " bytes compressed to " << recorded.compressedBytes;
         }
         else
         {
-            std::cerr << "There was a problem starting server" << std::endl;
+            LOG_ERROR << "There was a problem starting server";
             return -1;
         }
     }
     catch (Wt::WServer::Exception &exception)
     {
-        std::cerr << "Wt::WServer exception caught: " << exception.what() << std::endl;
+        LOG_ERROR << "Wt::WServer exception caught: " << exception.what();
+        return -1;
+    }
+    catch (std::runtime_error &exception)
+    {
+        LOG_ERROR << "Could not start web application: " << exception.what();
         return -1;
     }
     return 0;
@@ -42,20 +69,17 @@ bool WebAppLauncher::loadNeuralNetwork()
         return true;
     try
     {
-        std::ifstream file(_arguments->neuralNetworkFileName);
-        if (!file.is_open())
-        {
-            std::cerr << "Neural network file could not be opened (" << _arguments->neuralNetworkFileName << ")" << std::endl;
-            return false;
-        }
-        _neuralNetwork = NeuralNetwork::NetworkSerializer::deserialize(file);
-        file.close();
+        _evaluator = std::make_unique<ReloadableBoardEvaluator>(ModelReloader::load(_arguments->neuralNetworkFileName));
     }
     catch (std::runtime_error &exception)
     {
-        std::cerr << "Error during neural network deserialization: " << exception.what() << std::endl;
+        LOG_ERROR << "Error during neural network deserialization: " << exception.what();
         return false;
     }
+    // Sessions keep using the evaluator, new versions of the file are swapped in
+    if (_arguments->modelReloadInterval > 0)
+        _modelReloader = std::make_unique<ModelReloader>(_arguments->neuralNetworkFileName, *_evaluator,
+                                                         std::chrono::seconds(_arguments->modelReloadInterval));
     return true;
 }
 
@@ -75,8 +99,21 @@ void WebAppLauncher::setupServer()
     _server = std::make_unique<Wt::WServer>(argc, const_cast<char **>(argv));
     _server->addEntryPoint(Wt::EntryPointType::Application,
                            [this] (const Wt::WEnvironment &environment) {
-        return std::make_unique<WebApplication>(environment, _neuralNetwork.get(), _arguments->highscoreThreshold);
+        return std::make_unique<WebApplication>(environment, _evaluator.get(), _inferenceService.get(), searchSettings(),
+                                                _arguments->highscoreThreshold, _replayRecorder.get(),
+                                                _spectatorChannel.get(), _moveScheduler.get(), _metrics.get());
     });
+    _server->addResource(_metricsResource.get(), "/metrics");
+}
+
+ExpectimaxSettings WebAppLauncher::searchSettings() const
+{
+    ExpectimaxSettings settings;
+    settings.depth = _arguments->searchDepth;
+    settings.timeBudget = _arguments->searchTimeBudget;
+    settings.threadCount = _arguments->searchThreadCount;
+    settings.threadPool = _searchThreadPool.get();
+    return settings;
 }
 
 }
@@ -3,8 +3,18 @@
 
 #include "Application.h"
 #include <Wt/WServer.h>
-#include <Network.h>
 #include "arguments/WebAppArguments.h"
+#include "utils/BoardEvaluator.h"
+#include "utils/ExpectimaxSearch.h"
+#include "utils/InferenceService.h"
+#include "utils/ModelReloader.h"
+#include "utils/ReloadableBoardEvaluator.h"
+#include "utils/ReplayRecorder.h"
+#include "utils/ThreadPool.h"
+#include "utils/TimerWheel.h"
+#include "utils/WebAppMetrics.h"
+#include "web/MetricsResource.h"
+#include "web/SpectatorChannel.h"
 
 namespace nn2048
 {
@@ -19,12 +29,25 @@ public:
 protected:
     bool loadNeuralNetwork();
     void setupServer();
+    ExpectimaxSettings searchSettings() const;
 
 private:
     std::unique_ptr<WebAppArguments> _arguments;
 
+    /// Updated by sessions, the server must not outlive them
+    std::unique_ptr<WebAppMetrics> _metrics;
+    std::unique_ptr<MetricsResource> _metricsResource;
     std::unique_ptr<Wt::WServer> _server;
-    std::unique_ptr<NeuralNetwork::Network> _neuralNetwork;
+    std::unique_ptr<ReloadableBoardEvaluator> _evaluator;
+    std::unique_ptr<ModelReloader> _modelReloader;
+    std::unique_ptr<ReplayRecorder> _replayRecorder;
+    std::unique_ptr<SpectatorChannel> _spectatorChannel;
+    /// Times moves of all network controlled sessions
+    std::unique_ptr<TimerWheel> _moveScheduler;
+    /// Root moves of all expectimax sessions are searched here
+    std::unique_ptr<ThreadPool> _searchThreadPool;
+    /// Shared by all sessions, stopped before the evaluator is released
+    std::unique_ptr<InferenceService> _inferenceService;
 };
 
 }
@@ -35,6 +35,21 @@ bool ArgumentParser::tryParseUnsigned(const char *param, unsigned &out) const
     return true;
 }
 
+bool ArgumentParser::tryParseUnsignedLongLong(const char *param, unsigned long long &out) const
+{
+    try {
+        size_t index = 0;
+        out = std::stoull(param, &index);
+        if (index < strlen(param))
+            return false;
+    } catch (std::invalid_argument ex) {
+        return false;
+    } catch (std::out_of_range ex) {
+        return false;
+    }
+    return true;
+}
+
 bool ArgumentParser::tryParseDouble(const char *param, double &out) const
 {
     try {
@@ -52,4 +67,31 @@ bool ArgumentParser::tryParseDouble(const char *param, double &out) const
     return true;
 }
 
+bool ArgumentParser::parseSeed(Arguments &arguments)
+{
+    unsigned long long seed = 0;
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Seed argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsignedLongLong(_argv[++_currentArgIndex], seed)) {
+        std::cerr << "Could not parse seed" << std::endl;
+        return false;
+    }
+    arguments.seed = seed;
+    arguments.hasSeed = true;
+    return true;
+}
+
+bool ArgumentParser::parseLogLevel(Arguments &arguments)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Log level argument requires parameter" << std::endl;
+        return false;
+    } else if (!Logger::tryParseLevel(_argv[++_currentArgIndex], arguments.logLevel)) {
+        std::cerr << "Could not parse log level " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
 }
@@ -18,6 +18,12 @@ protected:
     bool hasParameter(unsigned index) const;
     bool tryParseUnsigned(const char *param, unsigned &out) const;
     bool tryParseDouble(const char *param, double &out) const;
+    bool tryParseUnsignedLongLong(const char *param, unsigned long long &out) const;
+
+    /// Parses seed argument common for all modes
+    bool parseSeed(Arguments &arguments);
+    /// Parses log level argument common for all modes
+    bool parseLogLevel(Arguments &arguments);
 
 protected:
     int _argc;
@@ -6,4 +6,7 @@ Arguments::Arguments() {}
 
 Arguments::~Arguments() {}
 
+const std::string Arguments::SeedArgument = "--seed";
+const std::string Arguments::LogLevelArgument = "--log-level";
+
 }
@@ -1,6 +1,10 @@
 #ifndef ARGUMENTS_H
 #define ARGUMENTS_H
 
+#include <cstdint>
+#include <string>
+#include "../utils/Logger.h"
+
 namespace nn2048 {
 
 /// Base class for all arguments classes
@@ -9,6 +13,15 @@ class Arguments
 public:
     Arguments();
     virtual ~Arguments();
+
+    /// Seed of all random streams, picked at random when not specified
+    std::uint64_t seed = 0;
+    bool hasSeed = false;
+    /// Lines below this level are filtered out
+    LogLevel logLevel = LogLevel::Info;
+
+    const static std::string SeedArgument;
+    const static std::string LogLevelArgument;
 };
 
 }
@@ -0,0 +1,22 @@
+#include "LoadTestArguments.h"
+
+namespace nn2048 {
+
+const std::string LoadTestArguments::ControllerArgument = "-c";
+const std::string LoadTestArguments::NeuralNetworkFileNameArgument = "-n";
+const std::string LoadTestArguments::AppRootDirectoryArgument = "-a";
+const std::string LoadTestArguments::SessionCountArgument = "-s";
+const std::string LoadTestArguments::MoveRateArgument = "-r";
+const std::string LoadTestArguments::DurationArgument = "-d";
+const std::string LoadTestArguments::ThreadCountArgument = "-w";
+const std::string LoadTestArguments::SearchDepthArgument = "-e";
+const std::string LoadTestArguments::SearchTimeBudgetArgument = "-b";
+const std::string LoadTestArguments::SearchThreadCountArgument = "-j";
+const std::string LoadTestArguments::InferenceLatencyArgument = "-l";
+const std::string LoadTestArguments::InferenceThreadCountArgument = "-i";
+
+const std::string LoadTestArguments::KeyboardControllerValue = "keyboard";
+const std::string LoadTestArguments::NeuralNetworkControllerValue = "neural";
+const std::string LoadTestArguments::ExpectimaxControllerValue = "expectimax";
+
+}
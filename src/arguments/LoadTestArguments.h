@@ -0,0 +1,46 @@
+#ifndef LOADTESTARGUMENTS_H
+#define LOADTESTARGUMENTS_H
+
+#include "Arguments.h"
+#include <string>
+#include "../utils/Defaults.h"
+
+namespace nn2048 {
+
+class LoadTestArguments : public Arguments
+{
+public:
+    std::string controller = "keyboard";
+    std::string neuralNetworkFileName;
+    std::string appRootDirectory;
+    unsigned sessionCount = DefaultLoadTestSessionCount;
+    unsigned moveRate = DefaultLoadTestMoveRate;
+    unsigned duration = DefaultLoadTestDuration;
+    unsigned threadCount = DefaultLoadTestThreadCount;
+    unsigned searchDepth = DefaultSearchDepth;
+    unsigned searchTimeBudget = DefaultSearchTimeBudget;
+    unsigned searchThreadCount = DefaultSearchThreadCount;
+    unsigned inferenceLatency = DefaultInferenceLatency;
+    unsigned inferenceThreadCount = DefaultInferenceThreadCount;
+
+    static const std::string ControllerArgument;
+    static const std::string NeuralNetworkFileNameArgument;
+    static const std::string AppRootDirectoryArgument;
+    static const std::string SessionCountArgument;
+    static const std::string MoveRateArgument;
+    static const std::string DurationArgument;
+    static const std::string ThreadCountArgument;
+    static const std::string SearchDepthArgument;
+    static const std::string SearchTimeBudgetArgument;
+    static const std::string SearchThreadCountArgument;
+    static const std::string InferenceLatencyArgument;
+    static const std::string InferenceThreadCountArgument;
+
+    static const std::string KeyboardControllerValue;
+    static const std::string NeuralNetworkControllerValue;
+    static const std::string ExpectimaxControllerValue;
+};
+
+}
+
+#endif // LOADTESTARGUMENTS_H
@@ -0,0 +1,224 @@
+#include "LoadTestArgumentsParser.h"
+#include <iostream>
+#include "LoadTestArguments.h"
+
+namespace nn2048 {
+
+LoadTestArgumentsParser::LoadTestArgumentsParser(int argc, char **argv) :
+    ArgumentParser(argc, argv, 2)
+{}
+
+std::unique_ptr<Arguments> LoadTestArgumentsParser::parsedArguments()
+{
+    auto arguments = std::make_unique<LoadTestArguments>();
+    for (; _currentArgIndex < static_cast<unsigned>(_argc); ++_currentArgIndex) {
+        auto currentArg = _argv[_currentArgIndex];
+        if (currentArg == LoadTestArguments::ControllerArgument) {
+            if (!parseController(arguments->controller))
+                return nullptr;
+        } else if (currentArg == LoadTestArguments::NeuralNetworkFileNameArgument) {
+            if (!parseNeuralNetworkFileName(arguments->neuralNetworkFileName))
+                return nullptr;
+        } else if (currentArg == LoadTestArguments::AppRootDirectoryArgument) {
+            if (!parseAppRootDirectory(arguments->appRootDirectory))
+                return nullptr;
+        } else if (currentArg == LoadTestArguments::SessionCountArgument) {
+            if (!parseSessionCount(arguments->sessionCount))
+                return nullptr;
+        } else if (currentArg == LoadTestArguments::MoveRateArgument) {
+            if (!parseMoveRate(arguments->moveRate))
+                return nullptr;
+        } else if (currentArg == LoadTestArguments::DurationArgument) {
+            if (!parseDuration(arguments->duration))
+                return nullptr;
+        } else if (currentArg == LoadTestArguments::ThreadCountArgument) {
+            if (!parseThreadCount(arguments->threadCount))
+                return nullptr;
+        } else if (currentArg == LoadTestArguments::SearchDepthArgument) {
+            if (!parseSearchDepth(arguments->searchDepth))
+                return nullptr;
+        } else if (currentArg == LoadTestArguments::SearchTimeBudgetArgument) {
+            if (!parseSearchTimeBudget(arguments->searchTimeBudget))
+                return nullptr;
+        } else if (currentArg == LoadTestArguments::SearchThreadCountArgument) {
+            if (!parseSearchThreadCount(arguments->searchThreadCount))
+                return nullptr;
+        } else if (currentArg == LoadTestArguments::InferenceLatencyArgument) {
+            if (!parseInferenceLatency(arguments->inferenceLatency))
+                return nullptr;
+        } else if (currentArg == LoadTestArguments::InferenceThreadCountArgument) {
+            if (!parseInferenceThreadCount(arguments->inferenceThreadCount))
+                return nullptr;
+        } else if (currentArg == Arguments::SeedArgument) {
+            if (!parseSeed(*arguments))
+                return nullptr;
+        } else if (currentArg == Arguments::LogLevelArgument) {
+            if (!parseLogLevel(*arguments))
+                return nullptr;
+        } else {
+            std::cerr << "Unknown argument " << currentArg << std::endl;
+            return nullptr;
+        }
+    }
+    bool networkController = arguments->controller != LoadTestArguments::KeyboardControllerValue;
+    if (networkController && arguments->neuralNetworkFileName.empty()) {
+        std::cerr << "Network file name required by " << arguments->controller << " sessions" << std::endl;
+        return nullptr;
+    } else if (arguments->sessionCount == 0) {
+        std::cerr << "Session count has to be greater than 0" << std::endl;
+        return nullptr;
+    } else if (arguments->duration == 0) {
+        std::cerr << "Duration has to be greater than 0" << std::endl;
+        return nullptr;
+    } else if (arguments->threadCount == 0) {
+        std::cerr << "Thread count has to be greater than 0" << std::endl;
+        return nullptr;
+    }
+    return arguments;
+}
+
+bool LoadTestArgumentsParser::parseController(std::string &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Controller argument requires parameter" << std::endl;
+        return false;
+    }
+    output = _argv[++_currentArgIndex];
+    if (output != LoadTestArguments::KeyboardControllerValue
+            && output != LoadTestArguments::NeuralNetworkControllerValue
+            && output != LoadTestArguments::ExpectimaxControllerValue) {
+        std::cerr << "Unknown controller " << output << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool LoadTestArgumentsParser::parseNeuralNetworkFileName(std::string &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Neural network file name argument requires parameter" << std::endl;
+        return false;
+    }
+    output = _argv[++_currentArgIndex];
+    return true;
+}
+
+bool LoadTestArgumentsParser::parseAppRootDirectory(std::string &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "App root directory argument requires parameter" << std::endl;
+        return false;
+    }
+    output = _argv[++_currentArgIndex];
+    return true;
+}
+
+bool LoadTestArgumentsParser::parseSessionCount(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Session count argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse session count " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool LoadTestArgumentsParser::parseMoveRate(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Move rate argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse move rate " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool LoadTestArgumentsParser::parseDuration(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Duration argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse duration " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool LoadTestArgumentsParser::parseThreadCount(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Thread count argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse thread count " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool LoadTestArgumentsParser::parseSearchDepth(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Search depth argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse search depth " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool LoadTestArgumentsParser::parseSearchTimeBudget(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Search time budget argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse search time budget " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool LoadTestArgumentsParser::parseSearchThreadCount(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Search thread count argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse search thread count " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool LoadTestArgumentsParser::parseInferenceLatency(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Inference latency argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse inference latency " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool LoadTestArgumentsParser::parseInferenceThreadCount(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Inference thread count argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse inference thread count " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,32 @@
+#ifndef LOADTESTARGUMENTSPARSER_H
+#define LOADTESTARGUMENTSPARSER_H
+
+#include "ArgumentParser.h"
+
+namespace nn2048 {
+
+class LoadTestArgumentsParser : public ArgumentParser
+{
+public:
+    LoadTestArgumentsParser(int argc, char **argv);
+
+    std::unique_ptr<Arguments> parsedArguments();
+
+private:
+    bool parseController(std::string &output);
+    bool parseNeuralNetworkFileName(std::string &output);
+    bool parseAppRootDirectory(std::string &output);
+    bool parseSessionCount(unsigned &output);
+    bool parseMoveRate(unsigned &output);
+    bool parseDuration(unsigned &output);
+    bool parseThreadCount(unsigned &output);
+    bool parseSearchDepth(unsigned &output);
+    bool parseSearchTimeBudget(unsigned &output);
+    bool parseSearchThreadCount(unsigned &output);
+    bool parseInferenceLatency(unsigned &output);
+    bool parseInferenceThreadCount(unsigned &output);
+};
+
+}
+
+#endif // LOADTESTARGUMENTSPARSER_H
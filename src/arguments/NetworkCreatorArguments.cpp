@@ -6,5 +6,6 @@ const std::string NetworkCreatorArguments::NetworkStructureArgument = "-s";
 const std::string NetworkCreatorArguments::NetworkFileNameArgument = "-o";
 const std::string NetworkCreatorArguments::WeightDistributionArgument = "-d";
 const std::string NetworkCreatorArguments::CreateFannNetworkArgument = "-f";
+const std::string NetworkCreatorArguments::CreateNTupleNetworkArgument = "-t";
 
 }
@@ -15,11 +15,13 @@ public:
     std::string networkFileName;
     double weightDistribution = DefaultWeightDistribution;
     bool createFannNetwork = false;
+    bool createNTupleNetwork = false;
 
     const static std::string NetworkStructureArgument;
     const static std::string NetworkFileNameArgument;
     const static std::string WeightDistributionArgument;
     const static std::string CreateFannNetworkArgument;
+    const static std::string CreateNTupleNetworkArgument;
 };
 
 }
@@ -29,6 +29,15 @@ std::unique_ptr<Arguments> NetworkCreatorArgumentsParser::parsedArguments()
         } else if (currentArg == NetworkCreatorArguments::CreateFannNetworkArgument) {
             if (!parseCreateFannNetwork(arguments->createFannNetwork))
                 return nullptr;
+        } else if (currentArg == NetworkCreatorArguments::CreateNTupleNetworkArgument) {
+            if (!parseCreateNTupleNetwork(arguments->createNTupleNetwork))
+                return nullptr;
+        } else if (currentArg == Arguments::SeedArgument) {
+            if (!parseSeed(*arguments))
+                return nullptr;
+        } else if (currentArg == Arguments::LogLevelArgument) {
+            if (!parseLogLevel(*arguments))
+                return nullptr;
         } else {
             std::cerr << "Unknown argument: " << currentArg << std::endl;
             return nullptr;
@@ -37,9 +46,12 @@ std::unique_ptr<Arguments> NetworkCreatorArgumentsParser::parsedArguments()
     if (arguments->networkFileName.length() == 0) {
         std::cerr << "Network file name not specified" << std::endl;
         return nullptr;
-    } else if (arguments->networkStructure.size() == 0) {
+    } else if (arguments->networkStructure.size() == 0 && !arguments->createNTupleNetwork) {
         std::cerr << "Network structure not specified" << std::endl;
         return nullptr;
+    } else if (arguments->createNTupleNetwork && arguments->createFannNetwork) {
+        std::cerr << "FANN and n-tuple network flags cannot be used together" << std::endl;
+        return nullptr;
     }
     return arguments;
 }
@@ -110,6 +122,16 @@ bool NetworkCreatorArgumentsParser::parseCreateFannNetwork(bool &output)
     return true;
 }
 
+bool NetworkCreatorArgumentsParser::parseCreateNTupleNetwork(bool &output)
+{
+    if (output) {
+        std::cerr << "Create n-tuple network flag was already set" << std::endl;
+        return false;
+    }
+    output = true;
+    return true;
+}
+
 std::vector<std::string> splitString(const std::string &string, char delimiter)
 {
     std::stringstream stream(string);
@@ -18,6 +18,7 @@ private:
     bool parseNetworkFileName(std::string &output);
     bool parseWeightDistribution(double &output);
     bool parseCreateFannNetwork(bool &output);
+    bool parseCreateNTupleNetwork(bool &output);
 };
 
 
@@ -0,0 +1,13 @@
+#include "NetworkEvaluatorArguments.h"
+
+namespace nn2048 {
+
+const std::string NetworkEvaluatorArguments::NetworkFileNameArgument = "-n";
+const std::string NetworkEvaluatorArguments::FannNetworkArgument = "-f";
+const std::string NetworkEvaluatorArguments::GameCountArgument = "-g";
+const std::string NetworkEvaluatorArguments::SearchDepthArgument = "-d";
+const std::string NetworkEvaluatorArguments::ProbabilityThresholdArgument = "-p";
+const std::string NetworkEvaluatorArguments::TimeBudgetArgument = "-t";
+const std::string NetworkEvaluatorArguments::ThreadCountArgument = "-j";
+
+}
@@ -0,0 +1,32 @@
+#ifndef NETWORKEVALUATORARGUMENTS_H
+#define NETWORKEVALUATORARGUMENTS_H
+
+#include "Arguments.h"
+#include <string>
+#include "../utils/Defaults.h"
+
+namespace nn2048 {
+
+class NetworkEvaluatorArguments : public Arguments
+{
+public:
+    std::string networkFileName;
+    bool fannNetwork = false;
+    unsigned gameCount = DefaultEvaluationGameCount;
+    unsigned searchDepth = DefaultSearchDepth;
+    double probabilityThreshold = DefaultSearchProbabilityThreshold;
+    unsigned timeBudget = DefaultSearchTimeBudget;
+    unsigned threadCount = DefaultSearchThreadCount;
+
+    const static std::string NetworkFileNameArgument;
+    const static std::string FannNetworkArgument;
+    const static std::string GameCountArgument;
+    const static std::string SearchDepthArgument;
+    const static std::string ProbabilityThresholdArgument;
+    const static std::string TimeBudgetArgument;
+    const static std::string ThreadCountArgument;
+};
+
+}
+
+#endif // NETWORKEVALUATORARGUMENTS_H
@@ -0,0 +1,138 @@
+#include "NetworkEvaluatorArgumentsParser.h"
+#include <iostream>
+#include "NetworkEvaluatorArguments.h"
+
+namespace nn2048 {
+
+NetworkEvaluatorArgumentsParser::NetworkEvaluatorArgumentsParser(int argc, char **argv) :
+    ArgumentParser(argc, argv, 2)
+{}
+
+std::unique_ptr<Arguments> NetworkEvaluatorArgumentsParser::parsedArguments()
+{
+    auto arguments = std::make_unique<NetworkEvaluatorArguments>();
+    for (; _currentArgIndex < static_cast<unsigned>(_argc); ++_currentArgIndex) {
+        auto currentArg = _argv[_currentArgIndex];
+        if (currentArg == NetworkEvaluatorArguments::NetworkFileNameArgument) {
+            if (!parseNetworkFileName(arguments->networkFileName))
+                return nullptr;
+        } else if (currentArg == NetworkEvaluatorArguments::FannNetworkArgument) {
+            if (!parseFannNetwork(arguments->fannNetwork))
+                return nullptr;
+        } else if (currentArg == NetworkEvaluatorArguments::GameCountArgument) {
+            if (!parseGameCount(arguments->gameCount))
+                return nullptr;
+        } else if (currentArg == NetworkEvaluatorArguments::SearchDepthArgument) {
+            if (!parseSearchDepth(arguments->searchDepth))
+                return nullptr;
+        } else if (currentArg == NetworkEvaluatorArguments::ProbabilityThresholdArgument) {
+            if (!parseProbabilityThreshold(arguments->probabilityThreshold))
+                return nullptr;
+        } else if (currentArg == NetworkEvaluatorArguments::TimeBudgetArgument) {
+            if (!parseTimeBudget(arguments->timeBudget))
+                return nullptr;
+        } else if (currentArg == NetworkEvaluatorArguments::ThreadCountArgument) {
+            if (!parseThreadCount(arguments->threadCount))
+                return nullptr;
+        } else if (currentArg == Arguments::SeedArgument) {
+            if (!parseSeed(*arguments))
+                return nullptr;
+        } else if (currentArg == Arguments::LogLevelArgument) {
+            if (!parseLogLevel(*arguments))
+                return nullptr;
+        } else {
+            std::cerr << "Unknown argument " << currentArg << std::endl;
+            return nullptr;
+        }
+    }
+    if (arguments->networkFileName.empty()) {
+        std::cerr << "Network file name not specified" << std::endl;
+        return nullptr;
+    } else if (arguments->gameCount == 0) {
+        std::cerr << "Game count has to be greater than 0" << std::endl;
+        return nullptr;
+    }
+    return arguments;
+}
+
+bool NetworkEvaluatorArgumentsParser::parseNetworkFileName(std::string &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Network file name argument requires parameter" << std::endl;
+        return false;
+    }
+    output = _argv[++_currentArgIndex];
+    return true;
+}
+
+bool NetworkEvaluatorArgumentsParser::parseFannNetwork(bool &output)
+{
+    if (output) {
+        std::cerr << "FANN network flag was already set" << std::endl;
+        return false;
+    }
+    output = true;
+    return true;
+}
+
+bool NetworkEvaluatorArgumentsParser::parseGameCount(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Game count argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse game count" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool NetworkEvaluatorArgumentsParser::parseSearchDepth(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Search depth argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse search depth" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool NetworkEvaluatorArgumentsParser::parseProbabilityThreshold(double &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Probability threshold argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseDouble(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse probability threshold" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool NetworkEvaluatorArgumentsParser::parseTimeBudget(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Time budget argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse time budget" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool NetworkEvaluatorArgumentsParser::parseThreadCount(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Thread count argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse thread count" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,27 @@
+#ifndef NETWORKEVALUATORARGUMENTSPARSER_H
+#define NETWORKEVALUATORARGUMENTSPARSER_H
+
+#include "ArgumentParser.h"
+
+namespace nn2048 {
+
+class NetworkEvaluatorArgumentsParser : public ArgumentParser
+{
+public:
+    NetworkEvaluatorArgumentsParser(int argc, char **argv);
+
+    std::unique_ptr<Arguments> parsedArguments();
+
+private:
+    bool parseNetworkFileName(std::string &output);
+    bool parseFannNetwork(bool &output);
+    bool parseGameCount(unsigned &output);
+    bool parseSearchDepth(unsigned &output);
+    bool parseProbabilityThreshold(double &output);
+    bool parseTimeBudget(unsigned &output);
+    bool parseThreadCount(unsigned &output);
+};
+
+}
+
+#endif // NETWORKEVALUATORARGUMENTSPARSER_H
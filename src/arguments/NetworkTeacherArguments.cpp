@@ -9,5 +9,10 @@ const std::string NetworkTeacherArguments::MinErrorArgument = "-e";
 const std::string NetworkTeacherArguments::LearningRateArgument = "-r";
 const std::string NetworkTeacherArguments::MomentumFactorArgument = "-m";
 const std::string NetworkTeacherArguments::GammaFactorArgument = "-g";
+const std::string NetworkTeacherArguments::ThreadCountArgument = "-j";
+const std::string NetworkTeacherArguments::StreamShardsArgument = "-s";
+const std::string NetworkTeacherArguments::ShuffleBufferSizeArgument = "-b";
+const std::string NetworkTeacherArguments::OptimizerArgument = "-o";
+const std::string NetworkTeacherArguments::BatchSizeArgument = "-k";
 
 }
@@ -17,6 +17,11 @@ public:
     double learningRate = DefaultLearningRate;
     double momentum = DefaultMomentumFactor;
     double gamma = DefaultGammaFactor;
+    unsigned threadCount = 0;
+    bool streamShards = false;
+    unsigned shuffleBufferSize = DefaultShuffleBufferSize;
+    std::string optimizer = "";
+    unsigned batchSize = DefaultOptimizerBatchSize;
 
     const static std::string NetworkFileNameArgument;
     const static std::string ReplayMemoryDirectoryArgument;
@@ -25,6 +30,11 @@ public:
     const static std::string LearningRateArgument;
     const static std::string MomentumFactorArgument;
     const static std::string GammaFactorArgument;
+    const static std::string ThreadCountArgument;
+    const static std::string StreamShardsArgument;
+    const static std::string ShuffleBufferSizeArgument;
+    const static std::string OptimizerArgument;
+    const static std::string BatchSizeArgument;
 };
 
 }
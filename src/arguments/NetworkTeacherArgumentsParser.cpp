@@ -12,6 +12,7 @@ NetworkTeacherArgumentsParser::NetworkTeacherArgumentsParser(int argc, char **ar
 std::unique_ptr<Arguments> NetworkTeacherArgumentsParser::parsedArguments()
 {
     auto arguments = std::make_unique<NetworkTeacherArguments>();
+    bool hasLearningRate = false;
     for (; _currentArgIndex < static_cast<unsigned>(_argc); ++_currentArgIndex) {
         auto currentArg = _argv[_currentArgIndex];
         if (currentArg == NetworkTeacherArguments::NetworkFileNameArgument) {
@@ -29,12 +30,34 @@ std::unique_ptr<Arguments> NetworkTeacherArgumentsParser::parsedArguments()
         } else if (currentArg == NetworkTeacherArguments::LearningRateArgument) {
             if (!parseLearningRate(arguments->learningRate))
                 return nullptr;
+            hasLearningRate = true;
         } else if (currentArg == NetworkTeacherArguments::MomentumFactorArgument) {
             if (!parseMomentumFactor(arguments->momentum))
                 return nullptr;
         } else if (currentArg == NetworkTeacherArguments::GammaFactorArgument) {
             if (!parseGammaFactor(arguments->gamma))
                 return nullptr;
+        } else if (currentArg == NetworkTeacherArguments::ThreadCountArgument) {
+            if (!parseThreadCount(arguments->threadCount))
+                return nullptr;
+        } else if (currentArg == NetworkTeacherArguments::StreamShardsArgument) {
+            if (!parseStreamShards(arguments->streamShards))
+                return nullptr;
+        } else if (currentArg == NetworkTeacherArguments::ShuffleBufferSizeArgument) {
+            if (!parseShuffleBufferSize(arguments->shuffleBufferSize))
+                return nullptr;
+        } else if (currentArg == NetworkTeacherArguments::OptimizerArgument) {
+            if (!parseOptimizer(arguments->optimizer))
+                return nullptr;
+        } else if (currentArg == NetworkTeacherArguments::BatchSizeArgument) {
+            if (!parseBatchSize(arguments->batchSize))
+                return nullptr;
+        } else if (currentArg == Arguments::SeedArgument) {
+            if (!parseSeed(*arguments))
+                return nullptr;
+        } else if (currentArg == Arguments::LogLevelArgument) {
+            if (!parseLogLevel(*arguments))
+                return nullptr;
         } else {
             std::cerr << "Unknown argument " << currentArg << std::endl;
             return nullptr;
@@ -49,7 +72,13 @@ std::unique_ptr<Arguments> NetworkTeacherArgumentsParser::parsedArguments()
     } else if (arguments->maxEpochs == 0 && std::abs(arguments->minError) < 0.000001) {
         std::cerr << "Missing learning limit condition (max epochs or min error)" << std::endl;
         return nullptr;
+    } else if (!arguments->optimizer.empty() && arguments->optimizer != "rprop" && arguments->optimizer != "adam") {
+        std::cerr << "Unknown optimizer " << arguments->optimizer << " (rprop or adam expected)" << std::endl;
+        return nullptr;
     }
+    // Default rate suits FANN and rprop, adam steps would be far too large
+    if (!hasLearningRate && arguments->optimizer == "adam")
+        arguments->learningRate = DefaultAdamLearningRate;
     return arguments;
 }
 
@@ -133,6 +162,60 @@ bool NetworkTeacherArgumentsParser::parseGammaFactor(double &output)
     return true;
 }
 
+bool NetworkTeacherArgumentsParser::parseThreadCount(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Thread count argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse thread count" << std::endl;
+        return false;
+    }
+    return true;
 }
 
+bool NetworkTeacherArgumentsParser::parseStreamShards(bool &output)
+{
+    if (output) {
+        std::cerr << "Stream shards flag was already set" << std::endl;
+        return false;
+    }
+    output = true;
+    return true;
+}
 
+bool NetworkTeacherArgumentsParser::parseShuffleBufferSize(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Shuffle buffer size argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse shuffle buffer size" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool NetworkTeacherArgumentsParser::parseOptimizer(std::string &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Optimizer argument requires parameter" << std::endl;
+        return false;
+    }
+    output = _argv[++_currentArgIndex];
+    return true;
+}
+
+bool NetworkTeacherArgumentsParser::parseBatchSize(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Batch size argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse batch size" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}
@@ -20,6 +20,11 @@ private:
     bool parseLearningRate(double &output);
     bool parseMomentumFactor(double &output);
     bool parseGammaFactor(double &output);
+    bool parseThreadCount(unsigned &output);
+    bool parseStreamShards(bool &output);
+    bool parseShuffleBufferSize(unsigned &output);
+    bool parseOptimizer(std::string &output);
+    bool parseBatchSize(unsigned &output);
 };
 
 }
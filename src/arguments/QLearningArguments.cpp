@@ -12,5 +12,6 @@ const std::string QLearningArguments::EpsilonFactorArgument = "-e";
 const std::string QLearningArguments::ReplayMemorySizeArgument = "-r";
 const std::string QLearningArguments::ReplayBatchSizeArgument = "-b";
 const std::string QLearningArguments::ReplayMemoryFileNameArgument = "-j";
+const std::string QLearningArguments::AfterstateLearningArgument = "-v";
 
 }
@@ -20,6 +20,7 @@ public:
     unsigned replayMemorySize = DefaultReplayMemorySize;
     unsigned replayBatchSize = DefaultReplayBatchSize;
     std::string replayMemoryFileName = "";
+    bool afterstateLearning = false;
 
     const static std::string NetworkFileNameArgument;
     const static std::string MaxAgeArgument;
@@ -31,6 +32,7 @@ public:
     const static std::string ReplayMemorySizeArgument;
     const static std::string ReplayBatchSizeArgument;
     const static std::string ReplayMemoryFileNameArgument;
+    const static std::string AfterstateLearningArgument;
 };
 
 }
@@ -43,6 +43,15 @@ std::unique_ptr<Arguments> QLearningArgumentsParser::parsedArguments()
         } else if (currentArg == QLearningArguments::ReplayMemoryFileNameArgument) {
             if (!parseReplayMemoryFileName(arguments->replayMemoryFileName))
                 return nullptr;
+        } else if (currentArg == QLearningArguments::AfterstateLearningArgument) {
+            if (!parseAfterstateLearning(arguments->afterstateLearning))
+                return nullptr;
+        } else if (currentArg == Arguments::SeedArgument) {
+            if (!parseSeed(*arguments))
+                return nullptr;
+        } else if (currentArg == Arguments::LogLevelArgument) {
+            if (!parseLogLevel(*arguments))
+                return nullptr;
         } else {
             std::cerr << "Unknown qlearning argument: " << currentArg << std::endl;
             return nullptr;
@@ -174,6 +183,14 @@ bool QLearningArgumentsParser::parseReplayMemoryFileName(std::string &output)
     return true;
 }
 
-
+bool QLearningArgumentsParser::parseAfterstateLearning(bool &output)
+{
+    if (output) {
+        std::cerr << "Afterstate learning flag was already set" << std::endl;
+        return false;
+    }
+    output = true;
+    return true;
+}
 
 }
@@ -23,6 +23,7 @@ private:
     bool parseReplayMemorySize(unsigned &output);
     bool parseReplayBatchSize(unsigned &output);
     bool parseReplayMemoryFileName(std::string &output);
+    bool parseAfterstateLearning(bool &output);
 };
 
 }
@@ -4,5 +4,11 @@ namespace nn2048 {
 
 const std::string ReplayMemoryMergerArguments::InputDirectoryArgument = "-i";
 const std::string ReplayMemoryMergerArguments::OutputFileNameArgument = "-o";
+const std::string ReplayMemoryMergerArguments::ThreadCountArgument = "-j";
+const std::string ReplayMemoryMergerArguments::DeduplicateArgument = "-d";
+const std::string ReplayMemoryMergerArguments::ReduceSymmetriesArgument = "-r";
+const std::string ReplayMemoryMergerArguments::GammaFactorArgument = "-g";
+const std::string ReplayMemoryMergerArguments::ShardCountArgument = "-n";
+const std::string ReplayMemoryMergerArguments::MaxSizeArgument = "--max-size";
 
 }
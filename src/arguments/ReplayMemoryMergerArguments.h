@@ -3,6 +3,7 @@
 
 #include "Arguments.h"
 #include <string>
+#include "../utils/Defaults.h"
 
 namespace nn2048 {
 
@@ -11,9 +12,21 @@ class ReplayMemoryMergerArguments : public Arguments
 public:
     std::string inputDirectory;
     std::string outputFileName;
+    unsigned threadCount = 0;
+    bool deduplicate = false;
+    bool reduceSymmetries = false;
+    double gamma = DefaultGammaFactor;
+    unsigned shardCount = 0;
+    unsigned maxSize = 0;
 
     const static std::string InputDirectoryArgument;
     const static std::string OutputFileNameArgument;
+    const static std::string ThreadCountArgument;
+    const static std::string DeduplicateArgument;
+    const static std::string ReduceSymmetriesArgument;
+    const static std::string GammaFactorArgument;
+    const static std::string ShardCountArgument;
+    const static std::string MaxSizeArgument;
 };
 
 }
@@ -19,6 +19,30 @@ std::unique_ptr<Arguments> ReplayMemoryMergerArgumentsParser::parsedArguments()
         } else if (currentArg == ReplayMemoryMergerArguments::OutputFileNameArgument) {
             if (!parseOutputFileName(arguments->outputFileName))
                 return nullptr;
+        } else if (currentArg == ReplayMemoryMergerArguments::ThreadCountArgument) {
+            if (!parseThreadCount(arguments->threadCount))
+                return nullptr;
+        } else if (currentArg == ReplayMemoryMergerArguments::DeduplicateArgument) {
+            if (!parseDeduplicate(arguments->deduplicate))
+                return nullptr;
+        } else if (currentArg == ReplayMemoryMergerArguments::ReduceSymmetriesArgument) {
+            if (!parseReduceSymmetries(arguments->reduceSymmetries))
+                return nullptr;
+        } else if (currentArg == ReplayMemoryMergerArguments::GammaFactorArgument) {
+            if (!parseGammaFactor(arguments->gamma))
+                return nullptr;
+        } else if (currentArg == ReplayMemoryMergerArguments::ShardCountArgument) {
+            if (!parseShardCount(arguments->shardCount))
+                return nullptr;
+        } else if (currentArg == ReplayMemoryMergerArguments::MaxSizeArgument) {
+            if (!parseMaxSize(arguments->maxSize))
+                return nullptr;
+        } else if (currentArg == Arguments::SeedArgument) {
+            if (!parseSeed(*arguments))
+                return nullptr;
+        } else if (currentArg == Arguments::LogLevelArgument) {
+            if (!parseLogLevel(*arguments))
+                return nullptr;
         } else {
             std::cerr << "Unknown argument " << currentArg << std::endl;
             return nullptr;
@@ -30,6 +54,12 @@ std::unique_ptr<Arguments> ReplayMemoryMergerArgumentsParser::parsedArguments()
     } else if (arguments->outputFileName.empty()) {
         std::cerr << "Missing output file name argument" << std::endl;
         return nullptr;
+    } else if (arguments->reduceSymmetries && !arguments->deduplicate) {
+        std::cerr << "Symmetry reduction requires deduplication" << std::endl;
+        return nullptr;
+    } else if (arguments->maxSize > 0 && arguments->deduplicate) {
+        std::cerr << "Max size cannot be combined with deduplication" << std::endl;
+        return nullptr;
     }
     return arguments;
 }
@@ -54,6 +84,72 @@ bool ReplayMemoryMergerArgumentsParser::parseOutputFileName(std::string &output)
     return true;
 }
 
+bool ReplayMemoryMergerArgumentsParser::parseThreadCount(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Thread count argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse thread count" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ReplayMemoryMergerArgumentsParser::parseDeduplicate(bool &output)
+{
+    if (output) {
+        std::cerr << "Deduplicate flag was already set" << std::endl;
+        return false;
+    }
+    output = true;
+    return true;
+}
+
+bool ReplayMemoryMergerArgumentsParser::parseReduceSymmetries(bool &output)
+{
+    if (output) {
+        std::cerr << "Reduce symmetries flag was already set" << std::endl;
+        return false;
+    }
+    output = true;
+    return true;
+}
+
+bool ReplayMemoryMergerArgumentsParser::parseGammaFactor(double &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Gamma factor argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseDouble(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse gamma factor" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ReplayMemoryMergerArgumentsParser::parseShardCount(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Shard count argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse shard count" << std::endl;
+        return false;
+    }
+    return true;
+}
 
+bool ReplayMemoryMergerArgumentsParser::parseMaxSize(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Max size argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse max size" << std::endl;
+        return false;
+    }
+    return true;
+}
 
 }
@@ -15,6 +15,12 @@ public:
 private:
     bool parseInputDirectory(std::string &output);
     bool parseOutputFileName(std::string &output);
+    bool parseThreadCount(unsigned &output);
+    bool parseDeduplicate(bool &output);
+    bool parseReduceSymmetries(bool &output);
+    bool parseGammaFactor(double &output);
+    bool parseShardCount(unsigned &output);
+    bool parseMaxSize(unsigned &output);
 };
 
 }
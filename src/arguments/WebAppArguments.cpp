@@ -9,5 +9,12 @@ const std::string WebAppArguments::ResourcesDirectoryArgument = "-r";
 const std::string WebAppArguments::AppRootDirectoryArgument = "-a";
 const std::string WebAppArguments::NeuralNetworkFileNameArgument = "-n";
 const std::string WebAppArguments::HighscoreThresholdArgument = "-t";
+const std::string WebAppArguments::SearchDepthArgument = "-e";
+const std::string WebAppArguments::SearchTimeBudgetArgument = "-b";
+const std::string WebAppArguments::SearchThreadCountArgument = "-j";
+const std::string WebAppArguments::InferenceLatencyArgument = "-l";
+const std::string WebAppArguments::InferenceThreadCountArgument = "-i";
+const std::string WebAppArguments::ModelReloadIntervalArgument = "-u";
+const std::string WebAppArguments::SpectatorMoveIntervalArgument = "-w";
 
 }
@@ -18,6 +18,13 @@ public:
     std::string appRootDirectory;
     std::string neuralNetworkFileName;
     unsigned long highscoreThreshold = DefaultHighscoreToRecordThreshold;
+    unsigned searchDepth = DefaultSearchDepth;
+    unsigned searchTimeBudget = DefaultSearchTimeBudget;
+    unsigned searchThreadCount = DefaultSearchThreadCount;
+    unsigned inferenceLatency = DefaultInferenceLatency;
+    unsigned inferenceThreadCount = DefaultInferenceThreadCount;
+    unsigned modelReloadInterval = DefaultModelReloadInterval;
+    unsigned spectatorMoveInterval = DefaultSpectatorMoveInterval;
 
     static const std::string PortArgument;
     static const std::string ServerNameArgument;
@@ -26,6 +33,13 @@ public:
     static const std::string AppRootDirectoryArgument;
     static const std::string NeuralNetworkFileNameArgument;
     static const std::string HighscoreThresholdArgument;
+    static const std::string SearchDepthArgument;
+    static const std::string SearchTimeBudgetArgument;
+    static const std::string SearchThreadCountArgument;
+    static const std::string InferenceLatencyArgument;
+    static const std::string InferenceThreadCountArgument;
+    static const std::string ModelReloadIntervalArgument;
+    static const std::string SpectatorMoveIntervalArgument;
 };
 
 }
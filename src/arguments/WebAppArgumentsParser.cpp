@@ -35,6 +35,33 @@ std::unique_ptr<Arguments> WebAppArgumentsParser::parsedArguments()
         } else if (currentArg == WebAppArguments::HighscoreThresholdArgument) {
             if (!parseHighscoreThreshold(arguments->highscoreThreshold))
                 return nullptr;
+        } else if (currentArg == WebAppArguments::SearchDepthArgument) {
+            if (!parseSearchDepth(arguments->searchDepth))
+                return nullptr;
+        } else if (currentArg == WebAppArguments::SearchTimeBudgetArgument) {
+            if (!parseSearchTimeBudget(arguments->searchTimeBudget))
+                return nullptr;
+        } else if (currentArg == WebAppArguments::SearchThreadCountArgument) {
+            if (!parseSearchThreadCount(arguments->searchThreadCount))
+                return nullptr;
+        } else if (currentArg == WebAppArguments::InferenceLatencyArgument) {
+            if (!parseInferenceLatency(arguments->inferenceLatency))
+                return nullptr;
+        } else if (currentArg == WebAppArguments::InferenceThreadCountArgument) {
+            if (!parseInferenceThreadCount(arguments->inferenceThreadCount))
+                return nullptr;
+        } else if (currentArg == WebAppArguments::ModelReloadIntervalArgument) {
+            if (!parseModelReloadInterval(arguments->modelReloadInterval))
+                return nullptr;
+        } else if (currentArg == WebAppArguments::SpectatorMoveIntervalArgument) {
+            if (!parseSpectatorMoveInterval(arguments->spectatorMoveInterval))
+                return nullptr;
+        } else if (currentArg == Arguments::SeedArgument) {
+            if (!parseSeed(*arguments))
+                return nullptr;
+        } else if (currentArg == Arguments::LogLevelArgument) {
+            if (!parseLogLevel(*arguments))
+                return nullptr;
         } else {
             std::cerr << "Unknown argument " << currentArg << std::endl;
             return nullptr;
@@ -138,4 +165,88 @@ bool WebAppArgumentsParser::parseHighscoreThreshold(unsigned long &output)
     return true;
 }
 
+bool WebAppArgumentsParser::parseSearchDepth(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Search depth argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse search depth " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool WebAppArgumentsParser::parseSearchTimeBudget(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Search time budget argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse search time budget " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool WebAppArgumentsParser::parseSearchThreadCount(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Search thread count argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse search thread count " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool WebAppArgumentsParser::parseInferenceLatency(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Inference latency window argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse inference latency window " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool WebAppArgumentsParser::parseInferenceThreadCount(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Inference thread count argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse inference thread count " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool WebAppArgumentsParser::parseModelReloadInterval(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Model reload interval argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse model reload interval " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool WebAppArgumentsParser::parseSpectatorMoveInterval(unsigned &output)
+{
+    if (!hasParameter(_currentArgIndex)) {
+        std::cerr << "Spectator move interval argument requires parameter" << std::endl;
+        return false;
+    } else if (!tryParseUnsigned(_argv[++_currentArgIndex], output)) {
+        std::cerr << "Could not parse spectator move interval " << _argv[_currentArgIndex] << std::endl;
+        return false;
+    }
+    return true;
+}
+
 }
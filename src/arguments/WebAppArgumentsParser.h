@@ -21,6 +21,13 @@ private:
     bool parseAppRootDirectory(std::string &output);
     bool parseNeuralNetworkFileName(std::string &output);
     bool parseHighscoreThreshold(unsigned long &output);
+    bool parseSearchDepth(unsigned &output);
+    bool parseSearchTimeBudget(unsigned &output);
+    bool parseSearchThreadCount(unsigned &output);
+    bool parseInferenceLatency(unsigned &output);
+    bool parseInferenceThreadCount(unsigned &output);
+    bool parseModelReloadInterval(unsigned &output);
+    bool parseSpectatorMoveInterval(unsigned &output);
 };
 
 }
@@ -1,5 +1,4 @@
 #include <csignal>
-#include <cstdlib>
 #include "Launcher.h"
 
 static nn2048::Application *app = nullptr;
@@ -13,7 +12,6 @@ void onSigInt(int)
 int main(int argc, char *argv[])
 {
     std::signal(SIGINT, &onSigInt);
-    std::srand(static_cast<unsigned int>(time(nullptr)));
     auto application = nn2048::Launcher::application(argc, argv);
     app = application.get();
     return application->run();
@@ -0,0 +1,82 @@
+#include "BatchOptimizer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace nn2048
+{
+
+namespace
+{
+
+const double rpropIncreaseFactor = 1.2;
+const double rpropDecreaseFactor = 0.5;
+const double rpropInitialStep = 0.1;
+const double rpropMinStep = 1e-6;
+const double rpropMaxStep = 50.0;
+
+const double adamFirstMomentDecay = 0.9;
+const double adamSecondMomentDecay = 0.999;
+const double adamEpsilon = 1e-8;
+
+}
+
+std::unique_ptr<BatchOptimizer> BatchOptimizer::create(const std::string &name, double learningRate)
+{
+    if (name == "rprop")
+        return std::make_unique<RpropOptimizer>();
+    else if (name == "adam")
+        return std::make_unique<AdamOptimizer>(learningRate);
+    return nullptr;
+}
+
+void RpropOptimizer::step(std::vector<double> &parameters, const std::vector<double> &gradient)
+{
+    if (_stepSizes.size() != parameters.size()) {
+        _stepSizes.assign(parameters.size(), rpropInitialStep);
+        _previousGradient.assign(parameters.size(), 0.0);
+    }
+
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        double currentGradient = gradient[i];
+        double signChange = currentGradient * _previousGradient[i];
+        if (signChange > 0.0) {
+            _stepSizes[i] = std::min(_stepSizes[i] * rpropIncreaseFactor, rpropMaxStep);
+        } else if (signChange < 0.0) {
+            _stepSizes[i] = std::max(_stepSizes[i] * rpropDecreaseFactor, rpropMinStep);
+            // Overshot minimum, skip update and do not count this sign next time
+            currentGradient = 0.0;
+        }
+        if (currentGradient > 0.0)
+            parameters[i] -= _stepSizes[i];
+        else if (currentGradient < 0.0)
+            parameters[i] += _stepSizes[i];
+        _previousGradient[i] = currentGradient;
+    }
+}
+
+AdamOptimizer::AdamOptimizer(double learningRate):
+    _learningRate(learningRate),
+    _stepCount(0)
+{}
+
+void AdamOptimizer::step(std::vector<double> &parameters, const std::vector<double> &gradient)
+{
+    if (_firstMoment.size() != parameters.size()) {
+        _firstMoment.assign(parameters.size(), 0.0);
+        _secondMoment.assign(parameters.size(), 0.0);
+        _stepCount = 0;
+    }
+
+    ++_stepCount;
+    double firstCorrection = 1.0 - std::pow(adamFirstMomentDecay, static_cast<double>(_stepCount));
+    double secondCorrection = 1.0 - std::pow(adamSecondMomentDecay, static_cast<double>(_stepCount));
+    double stepSize = _learningRate * std::sqrt(secondCorrection) / firstCorrection;
+
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        _firstMoment[i] = adamFirstMomentDecay * _firstMoment[i] + (1.0 - adamFirstMomentDecay) * gradient[i];
+        _secondMoment[i] = adamSecondMomentDecay * _secondMoment[i] + (1.0 - adamSecondMomentDecay) * gradient[i] * gradient[i];
+        parameters[i] -= stepSize * _firstMoment[i] / (std::sqrt(_secondMoment[i]) + adamEpsilon);
+    }
+}
+
+}
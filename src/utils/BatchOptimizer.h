@@ -0,0 +1,55 @@
+#ifndef BATCHOPTIMIZER_H
+#define BATCHOPTIMIZER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nn2048
+{
+
+/// Updates parameters from gradient accumulated over a whole batch
+class BatchOptimizer
+{
+public:
+    virtual ~BatchOptimizer() {}
+
+    virtual void step(std::vector<double> &parameters, const std::vector<double> &gradient) = 0;
+
+    /// Whether gradient has to be computed over all samples at once
+    virtual bool needsFullBatch() const = 0;
+
+    /// Creates optimizer by name ("rprop" or "adam"), nullptr for unknown names
+    static std::unique_ptr<BatchOptimizer> create(const std::string &name, double learningRate);
+};
+
+/// iRPROP-, step sizes adapt to gradient sign changes, gradient magnitude is ignored
+class RpropOptimizer: public BatchOptimizer
+{
+public:
+    void step(std::vector<double> &parameters, const std::vector<double> &gradient);
+    bool needsFullBatch() const { return true; }
+
+private:
+    std::vector<double> _stepSizes;
+    std::vector<double> _previousGradient;
+};
+
+class AdamOptimizer: public BatchOptimizer
+{
+public:
+    AdamOptimizer(double learningRate);
+
+    void step(std::vector<double> &parameters, const std::vector<double> &gradient);
+    bool needsFullBatch() const { return false; }
+
+private:
+    double _learningRate;
+    unsigned long _stepCount;
+    std::vector<double> _firstMoment;
+    std::vector<double> _secondMoment;
+};
+
+}
+
+#endif // BATCHOPTIMIZER_H
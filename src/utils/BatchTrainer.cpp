@@ -0,0 +1,101 @@
+#include "BatchTrainer.h"
+#include <algorithm>
+#include <future>
+#include <memory>
+#include "BoardSignalConverter.h"
+
+namespace nn2048
+{
+
+namespace
+{
+
+const size_t minSamplesPerWorker = 256;
+
+}
+
+BatchTrainer::BatchTrainer(const MultilayerPerceptron &perceptron, ThreadPool &threadPool):
+    _perceptron(perceptron),
+    _threadPool(threadPool)
+{
+    for (unsigned i = 0; i < _threadPool.threadCount(); ++i) {
+        _workspaces.push_back(_perceptron.createWorkspace());
+        _gradients.emplace_back(_perceptron.parameters().size(), 0.0);
+    }
+}
+
+double BatchTrainer::computeGradient(const TrainingSet &trainingSet, const std::vector<size_t> &order,
+                                     size_t first, size_t last, std::vector<double> &gradient)
+{
+    size_t sampleCount = last - first;
+    size_t workerCount = std::min<size_t>(_threadPool.threadCount(), std::max<size_t>(1, sampleCount / minSamplesPerWorker));
+    size_t samplesPerWorker = (sampleCount + workerCount - 1) / workerCount;
+
+    std::vector<std::future<double>> losses;
+    for (size_t i = 0; i < workerCount; ++i) {
+        size_t workerFirst = first + i * samplesPerWorker;
+        size_t workerLast = std::min(workerFirst + samplesPerWorker, last);
+        auto workerIndex = static_cast<unsigned>(i);
+        losses.push_back(_threadPool.submit([this, &trainingSet, &order, workerFirst, workerLast, workerIndex] () {
+            return accumulate(trainingSet, order, workerFirst, workerLast, workerIndex);
+        }));
+    }
+
+    double loss = 0.0;
+    for (auto &workerLoss: losses)
+        loss += workerLoss.get();
+
+    gradient.assign(_perceptron.parameters().size(), 0.0);
+    double scale = sampleCount > 0 ? 1.0 / static_cast<double>(sampleCount) : 0.0;
+    for (size_t i = 0; i < workerCount; ++i) {
+        auto &workerGradient = _gradients[i];
+        for (size_t j = 0; j < gradient.size(); ++j)
+            gradient[j] += workerGradient[j] * scale;
+    }
+    return loss;
+}
+
+double BatchTrainer::accumulate(const TrainingSet &trainingSet, const std::vector<size_t> &order,
+                                size_t first, size_t last, unsigned workerIndex)
+{
+    const unsigned outputCount = _perceptron.outputCount();
+    auto &workspace = _workspaces[workerIndex];
+    auto &gradient = _gradients[workerIndex];
+    std::fill(gradient.begin(), gradient.end(), 0.0);
+
+    unsigned activeInputs[BoardPacker::numberOfTiles];
+    std::vector<double> targets(outputCount);
+    std::unique_ptr<bool[]> mask(new bool[outputCount]);
+    double loss = 0.0;
+
+    for (size_t i = first; i < last; ++i) {
+        size_t index = order.empty() ? i : order[i];
+        auto &record = trainingSet.record(index);
+        double target = trainingSet.target(index);
+
+        size_t activeCount = 0;
+        for (unsigned tile = 0; tile < BoardPacker::numberOfTiles; ++tile) {
+            auto exponent = BoardPacker::exponent(record.board, tile);
+            if (exponent > 0)
+                activeInputs[activeCount++] = tile * BoardSignalConverter::numberOfPossibleValues + exponent - 1;
+        }
+
+        auto &outputs = _perceptron.forwardOneHot(activeInputs, activeCount, workspace);
+
+        // Same targets as incremental training, final state (Direction::None) pulls all moves
+        bool allOutputs = record.action >= outputCount;
+        double sampleLoss = 0.0;
+        for (unsigned j = 0; j < outputCount; ++j) {
+            mask[j] = allOutputs || j == record.action;
+            targets[j] = target;
+            if (mask[j])
+                sampleLoss += (outputs[j] - target) * (outputs[j] - target);
+        }
+        loss += allOutputs ? sampleLoss / outputCount : sampleLoss;
+
+        _perceptron.backwardOneHot(activeInputs, activeCount, &targets[0], mask.get(), workspace, gradient);
+    }
+    return loss;
+}
+
+}
@@ -0,0 +1,38 @@
+#ifndef BATCHTRAINER_H
+#define BATCHTRAINER_H
+
+#include <vector>
+#include "MultilayerPerceptron.h"
+#include "ThreadPool.h"
+#include "TrainingSet.h"
+
+namespace nn2048
+{
+
+/// Accumulates gradient of the move value loss over training samples.
+/// Samples are split between pool threads, each with own gradient buffer.
+/// Network input is the bit signal of the board (BoardSignalConverter).
+class BatchTrainer
+{
+public:
+    BatchTrainer(const MultilayerPerceptron &perceptron, ThreadPool &threadPool);
+
+    /// Computes mean gradient over samples order[first..last) (or first..last
+    /// when order is empty) and returns summed loss of these samples.
+    double computeGradient(const TrainingSet &trainingSet, const std::vector<size_t> &order,
+                           size_t first, size_t last, std::vector<double> &gradient);
+
+protected:
+    double accumulate(const TrainingSet &trainingSet, const std::vector<size_t> &order,
+                      size_t first, size_t last, unsigned workerIndex);
+
+private:
+    const MultilayerPerceptron &_perceptron;
+    ThreadPool &_threadPool;
+    std::vector<MultilayerPerceptron::Workspace> _workspaces;
+    std::vector<std::vector<double>> _gradients;
+};
+
+}
+
+#endif // BATCHTRAINER_H
@@ -0,0 +1,42 @@
+#include "BoardEvaluator.h"
+#include <limits>
+#include <cstddef>
+
+namespace nn2048
+{
+
+std::shared_ptr<const BoardEvaluator> BoardEvaluator::snapshot() const
+{
+    return std::shared_ptr<const BoardEvaluator>(std::shared_ptr<const BoardEvaluator>(), this);
+}
+
+void BoardEvaluator::evaluateMoves(const std::vector<PackedBoard> &boards, std::vector<double> &values) const
+{
+    const unsigned moveCount = static_cast<unsigned>(Game2048Core::Direction::Total);
+    std::vector<PackedBoard> afterstates;
+    std::vector<unsigned> rewards;
+    std::vector<size_t> valueIndices;
+    afterstates.reserve(boards.size() * moveCount);
+    rewards.reserve(boards.size() * moveCount);
+    valueIndices.reserve(boards.size() * moveCount);
+
+    values.assign(boards.size() * moveCount, std::numeric_limits<double>::lowest());
+    for (size_t i = 0; i < boards.size(); ++i) {
+        for (unsigned j = 0; j < moveCount; ++j) {
+            unsigned reward;
+            auto afterstate = BoardPacker::move(boards[i], static_cast<Game2048Core::Direction>(j), reward);
+            if (afterstate == boards[i])
+                continue;
+            afterstates.push_back(afterstate);
+            rewards.push_back(reward);
+            valueIndices.push_back(i * moveCount + j);
+        }
+    }
+
+    std::vector<double> afterstateValues;
+    evaluate(afterstates, afterstateValues);
+    for (size_t i = 0; i < afterstates.size(); ++i)
+        values[valueIndices[i]] = rewardWeight() * rewards[i] + afterstateValues[i];
+}
+
+}
@@ -0,0 +1,36 @@
+#ifndef BOARDEVALUATOR_H
+#define BOARDEVALUATOR_H
+
+#include <memory>
+#include <vector>
+#include "BoardPacker.h"
+
+namespace nn2048
+{
+
+/// Value function used by players and searches. Implementations have to be
+/// safe to call from multiple threads at once.
+class BoardEvaluator
+{
+public:
+    virtual ~BoardEvaluator() {}
+
+    /// Estimates value of every board. Boards are evaluated in one batch.
+    virtual void evaluate(const std::vector<PackedBoard> &boards, std::vector<double> &values) const = 0;
+
+    /// Estimates value of every move for every board. Values are stored
+    /// board by board, Direction::Total values per board. By default moves are
+    /// rated by the value of the board right after sliding the tiles.
+    virtual void evaluateMoves(const std::vector<PackedBoard> &boards, std::vector<double> &values) const;
+
+    /// Weight of tile merge reward added to evaluated values during search.
+    virtual double rewardWeight() const { return 0.0; }
+
+    /// Evaluator for a group of calls which has to see one model, e.g. a
+    /// whole search. Plain evaluators return themselves without ownership.
+    virtual std::shared_ptr<const BoardEvaluator> snapshot() const;
+};
+
+}
+
+#endif // BOARDEVALUATOR_H
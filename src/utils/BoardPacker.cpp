@@ -0,0 +1,173 @@
+#include "BoardPacker.h"
+#include <cmath>
+#include <vector>
+
+namespace nn2048
+{
+
+namespace
+{
+
+typedef std::uint16_t PackedRow;
+
+/// Results of sliding every possible row to the left and to the right.
+struct RowMoveTable
+{
+    std::vector<PackedRow> left;
+    std::vector<PackedRow> right;
+    std::vector<unsigned> reward;
+
+    RowMoveTable();
+};
+
+PackedRow reverseRow(PackedRow row)
+{
+    return static_cast<PackedRow>((row >> 12) | ((row >> 4) & 0x00F0) | ((row << 4) & 0x0F00) | (row << 12));
+}
+
+RowMoveTable::RowMoveTable():
+    left(1 << 16),
+    right(1 << 16),
+    reward(1 << 16)
+{
+    for (unsigned row = 0; row < (1 << 16); ++row) {
+        unsigned tiles[4] = { row & 0xF, (row >> 4) & 0xF, (row >> 8) & 0xF, (row >> 12) & 0xF };
+        unsigned result[4] = { 0, 0, 0, 0 };
+        unsigned rowReward = 0;
+        unsigned target = 0;
+        bool canMerge = false;
+
+        for (unsigned tile: tiles) {
+            if (tile == 0)
+                continue;
+            if (canMerge && result[target - 1] == tile && tile < BoardPacker::maxExponent) {
+                ++result[target - 1];
+                rowReward += 1u << result[target - 1];
+                canMerge = false;
+            } else {
+                result[target++] = tile;
+                canMerge = true;
+            }
+        }
+
+        auto moved = static_cast<PackedRow>(result[0] | (result[1] << 4) | (result[2] << 8) | (result[3] << 12));
+        left[row] = moved;
+        reward[row] = rowReward;
+    }
+    for (unsigned row = 0; row < (1 << 16); ++row)
+        right[row] = reverseRow(left[reverseRow(static_cast<PackedRow>(row))]);
+}
+
+const RowMoveTable &rowMoveTable()
+{
+    static const RowMoveTable table;
+    return table;
+}
+
+PackedBoard moveRows(PackedBoard board, const std::vector<PackedRow> &rowTable, unsigned &reward)
+{
+    const auto &table = rowMoveTable();
+    PackedBoard result = 0;
+    for (unsigned i = 0; i < 4; ++i) {
+        auto row = static_cast<PackedRow>(board >> (16 * i));
+        result |= static_cast<PackedBoard>(rowTable[row]) << (16 * i);
+        reward += table.reward[row];
+    }
+    return result;
+}
+
+}
+
+PackedBoard BoardPacker::pack(const Game2048Core::BoardState &board)
+{
+    PackedBoard packed = 0;
+    unsigned index = 0;
+    for (auto &row: board) {
+        for (auto &tile: row) {
+            if (tile.value() > 0) {
+                auto tileExponent = static_cast<unsigned>(std::log2(tile.value()));
+                packed = withExponent(packed, index, tileExponent < maxExponent ? tileExponent : maxExponent);
+            }
+            ++index;
+        }
+    }
+    return packed;
+}
+
+PackedBoard BoardPacker::withExponent(PackedBoard board, unsigned index, unsigned exponent)
+{
+    auto shift = 4 * index;
+    return (board & ~(static_cast<PackedBoard>(0xF) << shift)) | (static_cast<PackedBoard>(exponent & 0xF) << shift);
+}
+
+unsigned BoardPacker::maxTileExponent(PackedBoard board)
+{
+    unsigned result = 0;
+    for (unsigned i = 0; i < numberOfTiles; ++i) {
+        auto tileExponent = exponent(board, i);
+        if (tileExponent > result)
+            result = tileExponent;
+    }
+    return result;
+}
+
+unsigned BoardPacker::emptyTileCount(PackedBoard board)
+{
+    unsigned count = 0;
+    for (unsigned i = 0; i < numberOfTiles; ++i)
+        if (exponent(board, i) == 0)
+            ++count;
+    return count;
+}
+
+PackedBoard BoardPacker::move(PackedBoard board, Game2048Core::Direction direction, unsigned &reward)
+{
+    const auto &table = rowMoveTable();
+    reward = 0;
+    switch (direction)
+    {
+    case Game2048Core::Direction::Left:
+        return moveRows(board, table.left, reward);
+    case Game2048Core::Direction::Right:
+        return moveRows(board, table.right, reward);
+    case Game2048Core::Direction::Up:
+        return transpose(moveRows(transpose(board), table.left, reward));
+    case Game2048Core::Direction::Down:
+        return transpose(moveRows(transpose(board), table.right, reward));
+    default:
+        return board;
+    }
+}
+
+bool BoardPacker::canMove(PackedBoard board)
+{
+    unsigned reward;
+    for (unsigned i = 0; i < static_cast<unsigned>(Game2048Core::Direction::Total); ++i)
+        if (move(board, static_cast<Game2048Core::Direction>(i), reward) != board)
+            return true;
+    return false;
+}
+
+PackedBoard BoardPacker::transpose(PackedBoard board)
+{
+    PackedBoard a1 = board & 0xF0F00F0FF0F00F0FULL;
+    PackedBoard a2 = board & 0x0000F0F00000F0F0ULL;
+    PackedBoard a3 = board & 0x0F0F00000F0F0000ULL;
+    PackedBoard a = a1 | (a2 << 12) | (a3 >> 12);
+    PackedBoard b1 = a & 0xFF00FF0000FF00FFULL;
+    PackedBoard b2 = a & 0x00FF00FF00000000ULL;
+    PackedBoard b3 = a & 0x00000000FF00FF00ULL;
+    return b1 | (b2 >> 24) | (b3 << 24);
+}
+
+PackedBoard BoardPacker::mirror(PackedBoard board)
+{
+    PackedBoard result = 0;
+    for (unsigned i = 0; i < 4; ++i) {
+        auto row = static_cast<PackedRow>(board >> (16 * i));
+        result |= static_cast<PackedBoard>(reverseRow(row)) << (16 * i);
+    }
+    return result;
+}
+
+}
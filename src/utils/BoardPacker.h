@@ -0,0 +1,39 @@
+#ifndef BOARDPACKER_H
+#define BOARDPACKER_H
+
+#include <cstdint>
+#include <GameCore.h>
+
+namespace nn2048
+{
+
+/// 4x4 board packed into 64 bits. Every tile occupies one nibble holding
+/// log2 of its value (0 for an empty tile). Tile (row, column) is stored
+/// at nibble row * 4 + column, so each row is a 16 bit word.
+typedef std::uint64_t PackedBoard;
+
+class BoardPacker
+{
+public:
+    const static unsigned numberOfTiles = 16;
+    const static unsigned maxExponent = 15;
+
+    static PackedBoard pack(const Game2048Core::BoardState &board);
+
+    static unsigned exponent(PackedBoard board, unsigned index) { return (board >> (4 * index)) & 0xF; }
+    static PackedBoard withExponent(PackedBoard board, unsigned index, unsigned exponent);
+    static unsigned maxTileExponent(PackedBoard board);
+    static unsigned emptyTileCount(PackedBoard board);
+
+    /// Slides tiles in given direction. Sum of merged tile values is stored in reward.
+    /// Returned board equals the input board if the move is illegal.
+    static PackedBoard move(PackedBoard board, Game2048Core::Direction direction, unsigned &reward);
+    static bool canMove(PackedBoard board);
+
+    static PackedBoard transpose(PackedBoard board);
+    static PackedBoard mirror(PackedBoard board);
+};
+
+}
+
+#endif // BOARDPACKER_H
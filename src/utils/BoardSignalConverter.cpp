@@ -56,6 +56,33 @@ std::vector<double> BoardSignalConverter::boardToBitSignal(const Game2048Core::B
     return signal;
 }
 
+std::vector<double> BoardSignalConverter::packedBoardToSignal(PackedBoard board)
+{
+    std::vector<double> signal;
+    signal.reserve(numberOfTiles);
+    double log2maxValue = BoardPacker::maxTileExponent(board);
+
+    for (unsigned i = 0; i < numberOfTiles; ++i)
+    {
+        double log2value = BoardPacker::exponent(board, i);
+        signal.push_back(log2maxValue > 0.0 ? log2value / log2maxValue : 0.0);
+    }
+
+    return signal;
 }
 
+std::vector<double> BoardSignalConverter::packedBoardToBitSignal(PackedBoard board)
+{
+    auto signal = std::vector<double>(numberOfSignalBits);
+
+    for (unsigned i = 0; i < numberOfTiles; ++i) {
+        auto exponent = BoardPacker::exponent(board, i);
+        if (exponent > 0)
+            signal[i * numberOfPossibleValues + exponent - 1] = 1.0;
+    }
+
+    return signal;
+}
+
+}
 
@@ -2,6 +2,7 @@
 #define BOARDSIGNALCONVERTER_H
 
 #include <GameCore.h>
+#include "BoardPacker.h"
 
 namespace nn2048
 {
@@ -15,6 +16,8 @@ public:
 
     static std::vector<double> boardToSignal(const Game2048Core::BoardState &board);
     static std::vector<double> boardToBitSignal(const Game2048Core::BoardState &board);
+    static std::vector<double> packedBoardToSignal(PackedBoard board);
+    static std::vector<double> packedBoardToBitSignal(PackedBoard board);
 
     static double maxTileValue(const Game2048Core::BoardState &board);
 };
@@ -8,14 +8,40 @@ const double DefaultWeightDistribution = 0.02;
 
 const double DefaultGammaFactor = 0.5;
 const double DefaultLearningRate = 0.08;
+const double DefaultAdamLearningRate = 0.001;
 const double DefaultMomentumFactor = 0.02;
 const double DefaultEpsilonFactor = 0.15;
 const unsigned DefaultReplayMemorySize = 100000;
 const unsigned DefaultReplayBatchSize = 5000;
+const unsigned DefaultShuffleBufferSize = 100000;
+const unsigned DefaultOptimizerBatchSize = 1024;
+
+const unsigned DefaultSearchDepth = 2;
+const double DefaultSearchProbabilityThreshold = 0.0001;
+const unsigned DefaultSearchTimeBudget = 100;
+const unsigned DefaultSearchThreadCount = 4;
+const unsigned DefaultInferenceLatency = 2000;
+const unsigned DefaultInferenceThreadCount = 1;
+const unsigned DefaultInferenceBatchSize = 256;
+const unsigned DefaultModelReloadInterval = 5;
+const unsigned DefaultSpectatorMoveInterval = 500;
+const unsigned DefaultMoveDelay = 500;
+const unsigned DefaultSchedulerTick = 10;
+const unsigned DefaultSchedulerSlotCount = 512;
+const unsigned DefaultEvaluationGameCount = 10;
+const unsigned DefaultLoadTestSessionCount = 100;
+const unsigned DefaultLoadTestMoveRate = 10;
+const unsigned DefaultLoadTestDuration = 30;
+const unsigned DefaultLoadTestThreadCount = 4;
 
 const unsigned short DefaultServerPort = 4000;
 
 const unsigned long DefaultHighscoreToRecordThreshold = 10000;
+const unsigned DefaultRecorderQueueCapacity = 1024;
+const unsigned long DefaultRecorderFileSize = 64ul * 1024 * 1024;
+
+const unsigned DefaultLogBufferSize = 4096;
+const unsigned DefaultLogFlushInterval = 50;
 
 }
 
@@ -0,0 +1,212 @@
+#include "ExpectimaxSearch.h"
+#include <algorithm>
+#include <limits>
+
+namespace nn2048
+{
+
+namespace
+{
+
+const double twoSpawnProbability = 0.9;
+const double fourSpawnProbability = 0.1;
+const unsigned long nodesPerClockCheck = 1024;
+/// Lost position has no future reward, unlike what the evaluator predicts for it
+const double gameOverValue = 0.0;
+
+}
+
+ExpectimaxSearch::ExpectimaxSearch(const BoardEvaluator *evaluator, const ExpectimaxSettings &settings):
+    _evaluator(evaluator),
+    _settings(settings)
+{
+    // Calling thread searches too, so the pool needs one thread less
+    if (!_settings.threadPool && _settings.threadCount > 1) {
+        _ownThreadPool = std::make_unique<ThreadPool>(_settings.threadCount - 1);
+        _settings.threadPool = _ownThreadPool.get();
+    }
+}
+
+DirectionSignalVector ExpectimaxSearch::rankMoves(PackedBoard board) const
+{
+    DirectionSignalVector moves;
+    for (unsigned i = 0; i < static_cast<unsigned>(Game2048Core::Direction::Total); ++i) {
+        auto direction = static_cast<Game2048Core::Direction>(i);
+        unsigned reward;
+        if (BoardPacker::move(board, direction, reward) != board)
+            moves.push_back({ direction, 0.0 });
+    }
+    if (moves.size() < 2)
+        return moves;
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::milliseconds(_settings.timeBudget);
+    bool hasDeadline = _settings.timeBudget > 0;
+
+    // Whole search uses one model even if evaluator gets replaced meanwhile
+    auto evaluator = _evaluator->snapshot();
+
+    // First iteration always completes, deeper ones are dropped when out of time
+    std::vector<double> values;
+    std::vector<double> bestValues;
+    unsigned depth = _settings.depth > 0 ? 1 : 0;
+    for (; depth <= _settings.depth; ++depth) {
+        bool isFirstIteration = bestValues.empty();
+        if (!searchMoves(evaluator.get(), moves, board, depth, deadline, hasDeadline && !isFirstIteration, values))
+            break;
+        bestValues = values;
+        if (hasDeadline && std::chrono::steady_clock::now() >= deadline)
+            break;
+    }
+
+    for (size_t i = 0; i < moves.size(); ++i)
+        moves[i].second = bestValues[i];
+    std::sort(moves.begin(), moves.end(), [] (const DirectionSignal &s1, const DirectionSignal &s2) {
+        return s1.second > s2.second;
+    });
+    return moves;
+}
+
+Game2048Core::Direction ExpectimaxSearch::bestMove(PackedBoard board) const
+{
+    auto moves = rankMoves(board);
+    if (moves.empty())
+        return Game2048Core::Direction::None;
+    return moves.front().first;
+}
+
+bool ExpectimaxSearch::searchMoves(const BoardEvaluator *evaluator, const std::vector<DirectionSignal> &moves, PackedBoard board,
+                                   unsigned depth, const TimePoint &deadline, bool hasDeadline, std::vector<double> &values) const
+{
+    values.assign(moves.size(), 0.0);
+    auto searchRange = [&] (size_t first, size_t step) -> bool {
+        for (size_t i = first; i < moves.size(); i += step) {
+            SearchContext context;
+            context.evaluator = evaluator;
+            context.depth = depth;
+            context.deadline = deadline;
+            context.hasDeadline = hasDeadline;
+            context.aborted = false;
+            context.visitedNodes = 0;
+            if (!searchMove(board, moves[i].first, context, values[i]))
+                return false;
+        }
+        return true;
+    };
+
+    size_t threadCount = std::min<size_t>(std::max(_settings.threadCount, 1u), moves.size());
+    if (threadCount == 1 || !_settings.threadPool)
+        return searchRange(0, 1);
+
+    std::vector<std::future<bool>> tasks;
+    tasks.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; ++i)
+        tasks.push_back(_settings.threadPool->submit([&searchRange, i, threadCount] () { return searchRange(i, threadCount); }));
+    bool succeeded = searchRange(0, threadCount);
+    for (auto &task: tasks)
+        succeeded = task.get() && succeeded;
+    return succeeded;
+}
+
+bool ExpectimaxSearch::searchMove(PackedBoard board, Game2048Core::Direction direction, SearchContext &context, double &value) const
+{
+    unsigned reward;
+    auto afterstate = BoardPacker::move(board, direction, reward);
+
+    context.collectingLeaves = true;
+    chanceNode(afterstate, context.depth, 1.0, context);
+    if (context.aborted)
+        return false;
+    evaluatePendingLeaves(context);
+
+    context.collectingLeaves = false;
+    context.transpositions.clear();
+    value = context.evaluator->rewardWeight() * reward + chanceNode(afterstate, context.depth, 1.0, context);
+    return true;
+}
+
+double ExpectimaxSearch::maxNode(PackedBoard board, unsigned depth, double probability, SearchContext &context) const
+{
+    double bestValue = std::numeric_limits<double>::lowest();
+    bool hasLegalMove = false;
+    for (unsigned i = 0; i < static_cast<unsigned>(Game2048Core::Direction::Total) && !context.aborted; ++i) {
+        unsigned reward;
+        auto afterstate = BoardPacker::move(board, static_cast<Game2048Core::Direction>(i), reward);
+        if (afterstate == board)
+            continue;
+        hasLegalMove = true;
+        double value = context.evaluator->rewardWeight() * reward + chanceNode(afterstate, depth, probability, context);
+        if (value > bestValue)
+            bestValue = value;
+    }
+    if (!hasLegalMove)
+        return gameOverValue;
+    return bestValue;
+}
+
+double ExpectimaxSearch::chanceNode(PackedBoard board, unsigned depth, double probability, SearchContext &context) const
+{
+    if (depth == 0 || probability < _settings.probabilityThreshold)
+        return leaf(board, context);
+
+    // Subtree reached with higher probability than stored was pruned less, it is searched again
+    auto transposition = context.transpositions.find(board);
+    if (transposition != context.transpositions.end() && transposition->second.depth >= depth
+            && probability <= transposition->second.probability)
+        return transposition->second.value;
+
+    if (context.collectingLeaves && isOutOfTime(context))
+        context.aborted = true;
+    if (context.aborted)
+        return 0.0;
+
+    unsigned emptyTiles = BoardPacker::emptyTileCount(board);
+    if (emptyTiles == 0)
+        return leaf(board, context);
+
+    double value = 0.0;
+    for (unsigned i = 0; i < BoardPacker::numberOfTiles; ++i) {
+        if (BoardPacker::exponent(board, i) != 0)
+            continue;
+        value += twoSpawnProbability * maxNode(BoardPacker::withExponent(board, i, 1), depth - 1,
+                                               probability * twoSpawnProbability / emptyTiles, context);
+        value += fourSpawnProbability * maxNode(BoardPacker::withExponent(board, i, 2), depth - 1,
+                                                probability * fourSpawnProbability / emptyTiles, context);
+    }
+    value /= emptyTiles;
+
+    context.transpositions[board] = { depth, probability, value };
+    return value;
+}
+
+double ExpectimaxSearch::leaf(PackedBoard board, SearchContext &context) const
+{
+    if (context.collectingLeaves) {
+        if (context.leafValues.count(board) == 0)
+            context.pendingLeaves.insert(board);
+        return 0.0;
+    }
+    auto leafValue = context.leafValues.find(board);
+    return leafValue != context.leafValues.end() ? leafValue->second : 0.0;
+}
+
+void ExpectimaxSearch::evaluatePendingLeaves(SearchContext &context) const
+{
+    std::vector<PackedBoard> boards(context.pendingLeaves.begin(), context.pendingLeaves.end());
+    std::vector<double> values;
+    context.evaluator->evaluate(boards, values);
+    for (size_t i = 0; i < boards.size(); ++i)
+        context.leafValues[boards[i]] = values[i];
+    context.pendingLeaves.clear();
+}
+
+bool ExpectimaxSearch::isOutOfTime(SearchContext &context) const
+{
+    if (!context.hasDeadline)
+        return false;
+    if (++context.visitedNodes % nodesPerClockCheck != 0)
+        return false;
+    return std::chrono::steady_clock::now() >= context.deadline;
+}
+
+}
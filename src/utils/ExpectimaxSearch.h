@@ -0,0 +1,85 @@
+#ifndef EXPECTIMAXSEARCH_H
+#define EXPECTIMAXSEARCH_H
+
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include "BoardEvaluator.h"
+#include "NetworkOutputConverter.h"
+#include "Defaults.h"
+#include "ThreadPool.h"
+
+namespace nn2048
+{
+
+struct ExpectimaxSettings
+{
+    /// Number of tile spawns looked ahead, 0 makes the search greedy
+    unsigned depth = DefaultSearchDepth;
+    /// Chance nodes reached with lower probability are evaluated right away
+    double probabilityThreshold = DefaultSearchProbabilityThreshold;
+    /// Time budget per move in milliseconds, 0 disables the limit
+    unsigned timeBudget = DefaultSearchTimeBudget;
+    /// Number of threads root moves are split between
+    unsigned threadCount = DefaultSearchThreadCount;
+    /// Pool root moves are searched on, a search without one creates its own
+    ThreadPool *threadPool = nullptr;
+};
+
+/// Depth limited expectimax over moves and random 2/4 tile spawns. Leaves are
+/// collected first and evaluated by BoardEvaluator in one batch, then the tree
+/// is walked again with known leaf values. Search deepens iteratively until
+/// settings depth is reached or time budget runs out.
+class ExpectimaxSearch
+{
+public:
+    ExpectimaxSearch(const BoardEvaluator *evaluator, const ExpectimaxSettings &settings = ExpectimaxSettings());
+
+    /// Legal moves sorted from the best one. Empty when game is over.
+    DirectionSignalVector rankMoves(PackedBoard board) const;
+    Game2048Core::Direction bestMove(PackedBoard board) const;
+
+protected:
+    typedef std::chrono::steady_clock::time_point TimePoint;
+
+    struct TranspositionEntry
+    {
+        unsigned depth;
+        /// Probability the subtree was searched with, it was pruned below that
+        double probability;
+        double value;
+    };
+
+    struct SearchContext
+    {
+        const BoardEvaluator *evaluator;
+        unsigned depth;
+        TimePoint deadline;
+        bool hasDeadline;
+        bool collectingLeaves;
+        bool aborted;
+        unsigned long visitedNodes;
+        std::unordered_set<PackedBoard> pendingLeaves;
+        std::unordered_map<PackedBoard, double> leafValues;
+        std::unordered_map<PackedBoard, TranspositionEntry> transpositions;
+    };
+
+    bool searchMoves(const BoardEvaluator *evaluator, const std::vector<DirectionSignal> &moves, PackedBoard board,
+                     unsigned depth, const TimePoint &deadline, bool hasDeadline, std::vector<double> &values) const;
+    bool searchMove(PackedBoard board, Game2048Core::Direction direction, SearchContext &context, double &value) const;
+    double maxNode(PackedBoard board, unsigned depth, double probability, SearchContext &context) const;
+    double chanceNode(PackedBoard board, unsigned depth, double probability, SearchContext &context) const;
+    double leaf(PackedBoard board, SearchContext &context) const;
+    void evaluatePendingLeaves(SearchContext &context) const;
+    bool isOutOfTime(SearchContext &context) const;
+
+private:
+    const BoardEvaluator *_evaluator;
+    ExpectimaxSettings _settings;
+    std::unique_ptr<ThreadPool> _ownThreadPool;
+};
+
+}
+
+#endif // EXPECTIMAXSEARCH_H
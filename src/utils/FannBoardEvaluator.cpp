@@ -0,0 +1,70 @@
+#include "FannBoardEvaluator.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "BoardSignalConverter.h"
+
+namespace nn2048
+{
+
+FannBoardEvaluator::FannBoardEvaluator(FANN::neural_net *network):
+    _network(network),
+    _inputCount(network->get_num_input()),
+    _outputCount(network->get_num_output())
+{
+    // Other input counts would make FANN read past the encoded signal
+    if (!isSupportedInputCount(_inputCount))
+        throw std::runtime_error("Network input count " + std::to_string(_inputCount) + " matches no board encoding");
+}
+
+FannBoardEvaluator::FannBoardEvaluator(std::unique_ptr<FANN::neural_net> network):
+    FannBoardEvaluator(network.get())
+{
+    _ownedNetwork = std::move(network);
+}
+
+void FannBoardEvaluator::evaluate(const std::vector<PackedBoard> &boards, std::vector<double> &values) const
+{
+    values.clear();
+    values.reserve(boards.size());
+
+    // FANN keeps neuron values inside the network, so runs cannot overlap
+    std::lock_guard<std::mutex> lock(_networkMutex);
+    for (auto board: boards) {
+        auto inputs = encode(board);
+        auto outputs = _network->run(&inputs[0]);
+        values.push_back(*std::max_element(outputs, outputs + _outputCount));
+    }
+}
+
+void FannBoardEvaluator::evaluateMoves(const std::vector<PackedBoard> &boards, std::vector<double> &values) const
+{
+    if (_outputCount != static_cast<unsigned>(Game2048Core::Direction::Total)) {
+        BoardEvaluator::evaluateMoves(boards, values);
+        return;
+    }
+
+    values.clear();
+    values.reserve(boards.size() * _outputCount);
+
+    std::lock_guard<std::mutex> lock(_networkMutex);
+    for (auto board: boards) {
+        auto inputs = encode(board);
+        auto outputs = _network->run(&inputs[0]);
+        values.insert(values.end(), outputs, outputs + _outputCount);
+    }
+}
+
+bool FannBoardEvaluator::isSupportedInputCount(unsigned inputCount)
+{
+    return inputCount == BoardSignalConverter::numberOfSignalBits || inputCount == BoardSignalConverter::numberOfTiles;
+}
+
+std::vector<double> FannBoardEvaluator::encode(PackedBoard board) const
+{
+    if (_inputCount == BoardSignalConverter::numberOfSignalBits)
+        return BoardSignalConverter::packedBoardToBitSignal(board);
+    return BoardSignalConverter::packedBoardToSignal(board);
+}
+
+}
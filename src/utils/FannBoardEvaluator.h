@@ -0,0 +1,42 @@
+#ifndef FANNBOARDEVALUATOR_H
+#define FANNBOARDEVALUATOR_H
+
+#include <memory>
+#include <mutex>
+#include <doublefann.h>
+#include <fann_cpp.h>
+#include "BoardEvaluator.h"
+
+namespace nn2048
+{
+
+/// Evaluates boards with FANN network. Input encoding is picked by the
+/// network input count (16 - boardToSignal, 256 - boardToBitSignal).
+/// Network outputs are move values, board value is the greatest of them.
+class FannBoardEvaluator: public BoardEvaluator
+{
+public:
+    /// Throws std::runtime_error when input count matches no board encoding
+    FannBoardEvaluator(FANN::neural_net *network);
+    /// Evaluator owning the network
+    FannBoardEvaluator(std::unique_ptr<FANN::neural_net> network);
+
+    static bool isSupportedInputCount(unsigned inputCount);
+
+    void evaluate(const std::vector<PackedBoard> &boards, std::vector<double> &values) const;
+    void evaluateMoves(const std::vector<PackedBoard> &boards, std::vector<double> &values) const;
+
+    /// Network input signal for the board
+    std::vector<double> encode(PackedBoard board) const;
+
+private:
+    std::unique_ptr<FANN::neural_net> _ownedNetwork;
+    FANN::neural_net *_network;
+    unsigned _inputCount;
+    unsigned _outputCount;
+    mutable std::mutex _networkMutex;
+};
+
+}
+
+#endif // FANNBOARDEVALUATOR_H
@@ -0,0 +1,40 @@
+#ifndef FNV1A_H
+#define FNV1A_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nn2048
+{
+
+/// 64-bit FNV-1a hash. Unlike std::hash it gives the same value on every
+/// platform and run. Data can be fed in pieces as it is read.
+class Fnv1a
+{
+public:
+    void update(const void *data, size_t size)
+    {
+        auto bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; ++i) {
+            _hash ^= bytes[i];
+            _hash *= 0x100000001b3ULL;
+        }
+    }
+
+    std::uint64_t value() const { return _hash; }
+
+    static std::uint64_t hash(const std::string &text)
+    {
+        Fnv1a fnv;
+        fnv.update(text.data(), text.size());
+        return fnv.value();
+    }
+
+private:
+    std::uint64_t _hash = 0xcbf29ce484222325ULL;
+};
+
+}
+
+#endif // FNV1A_H
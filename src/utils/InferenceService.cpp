@@ -0,0 +1,115 @@
+#include "InferenceService.h"
+#include <algorithm>
+#include <stdexcept>
+#include <GameCore.h>
+#include "Logger.h"
+
+namespace nn2048
+{
+
+InferenceService::InferenceService(const BoardEvaluator *evaluator,
+                                   std::chrono::microseconds latencyWindow,
+                                   unsigned workerCount,
+                                   size_t maxBatchSize):
+    _evaluator(evaluator),
+    _latencyWindow(latencyWindow),
+    _maxBatchSize(std::max<size_t>(maxBatchSize, 1)),
+    _stopping(false),
+    _requestCount(0),
+    _batchCount(0)
+{
+    if (!_evaluator)
+        throw std::invalid_argument("Inference service requires evaluator");
+    for (unsigned i = 0; i < std::max(workerCount, 1u); ++i)
+        _workers.emplace_back(&InferenceService::workerLoop, this);
+}
+
+InferenceService::~InferenceService()
+{
+    {
+        std::lock_guard<std::mutex> lock(_requestsMutex);
+        _stopping = true;
+    }
+    _requestsCondition.notify_all();
+    for (auto &worker: _workers)
+        worker.join();
+}
+
+void InferenceService::submit(PackedBoard board, Callback callback)
+{
+    size_t queued;
+    {
+        std::lock_guard<std::mutex> lock(_requestsMutex);
+        _requests.push_back({ board, std::move(callback), std::chrono::steady_clock::now() });
+        queued = _requests.size();
+    }
+    // First request starts a window, full batch ends it early
+    if (queued == 1)
+        _requestsCondition.notify_one();
+    else if (queued >= _maxBatchSize)
+        _requestsCondition.notify_all();
+}
+
+void InferenceService::workerLoop()
+{
+    std::vector<Request> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_requestsMutex);
+            _requestsCondition.wait(lock, [this] () { return _stopping || !_requests.empty(); });
+            if (_requests.empty())
+                return;
+
+            auto deadline = _requests.front().submitted + _latencyWindow;
+            _requestsCondition.wait_until(lock, deadline, [this] () {
+                return _stopping || _requests.empty() || _requests.size() >= _maxBatchSize;
+            });
+            // Another worker may have taken the requests meanwhile
+            if (_requests.empty())
+                continue;
+
+            auto count = std::min(_requests.size(), _maxBatchSize);
+            batch.clear();
+            for (size_t i = 0; i < count; ++i) {
+                batch.push_back(std::move(_requests.front()));
+                _requests.pop_front();
+            }
+        }
+        evaluateBatch(batch);
+    }
+}
+
+void InferenceService::evaluateBatch(std::vector<Request> &batch)
+{
+    std::vector<PackedBoard> boards;
+    boards.reserve(batch.size());
+    for (auto &request: batch)
+        boards.push_back(request.board);
+
+    const size_t valuesPerBoard = static_cast<size_t>(Game2048Core::Direction::Total);
+    std::vector<double> values;
+    try {
+        _evaluator->evaluateMoves(boards, values);
+    } catch (std::exception &exception) {
+        LOG_WARNING << "InferenceService: evaluation failed: " << exception.what();
+        values.clear();
+    }
+    ++_batchCount;
+    _requestCount += batch.size();
+
+    auto evaluatedTime = std::chrono::steady_clock::now();
+    for (auto &request: batch)
+        _latency.observe(std::chrono::duration_cast<std::chrono::microseconds>(evaluatedTime - request.submitted));
+
+    bool evaluated = values.size() == boards.size() * valuesPerBoard;
+    std::vector<double> moveValues;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        moveValues.clear();
+        if (evaluated)
+            moveValues.assign(values.begin() + static_cast<std::ptrdiff_t>(i * valuesPerBoard),
+                              values.begin() + static_cast<std::ptrdiff_t>((i + 1) * valuesPerBoard));
+        batch[i].callback(moveValues);
+    }
+}
+
+}
@@ -0,0 +1,75 @@
+#ifndef INFERENCESERVICE_H
+#define INFERENCESERVICE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "BoardEvaluator.h"
+#include "LatencyHistogram.h"
+
+namespace nn2048
+{
+
+/// Evaluates move values of boards submitted by many game sessions. Worker
+/// threads wait for requests to gather within a latency window, counted
+/// from the oldest queued request, and evaluate all of them with a single
+/// evaluator call. Callbacks are invoked on worker threads.
+class InferenceService
+{
+public:
+    typedef std::function<void(const std::vector<double> &moveValues)> Callback;
+
+    InferenceService(const BoardEvaluator *evaluator,
+                     std::chrono::microseconds latencyWindow,
+                     unsigned workerCount = 1,
+                     size_t maxBatchSize = 256);
+    /// Evaluates queued requests before joining workers
+    ~InferenceService();
+
+    InferenceService(const InferenceService &) = delete;
+    InferenceService &operator = (const InferenceService &) = delete;
+
+    /// Callback gets Direction::Total values, or no values when evaluation failed
+    void submit(PackedBoard board, Callback callback);
+
+    std::uint64_t requestCount() const { return _requestCount; }
+    std::uint64_t batchCount() const { return _batchCount; }
+    /// Time from submit until move values are ready, per request
+    const LatencyHistogram &latencyHistogram() const { return _latency; }
+
+protected:
+    struct Request
+    {
+        PackedBoard board;
+        Callback callback;
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    void workerLoop();
+    void evaluateBatch(std::vector<Request> &batch);
+
+private:
+    const BoardEvaluator *_evaluator;
+    std::chrono::microseconds _latencyWindow;
+    size_t _maxBatchSize;
+
+    std::deque<Request> _requests;
+    std::mutex _requestsMutex;
+    std::condition_variable _requestsCondition;
+    bool _stopping;
+    std::vector<std::thread> _workers;
+
+    std::atomic<std::uint64_t> _requestCount;
+    std::atomic<std::uint64_t> _batchCount;
+    LatencyHistogram _latency;
+};
+
+}
+
+#endif // INFERENCESERVICE_H
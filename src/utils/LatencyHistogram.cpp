@@ -0,0 +1,33 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+
+namespace nn2048
+{
+
+LatencyHistogram::LatencyHistogram():
+    _count(0),
+    _sum(0)
+{
+    for (auto &bucket: _buckets)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+const std::array<std::uint64_t, LatencyHistogram::bucketCount - 1> &LatencyHistogram::bucketBounds()
+{
+    static const std::array<std::uint64_t, bucketCount - 1> bounds {{
+        50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000
+    }};
+    return bounds;
+}
+
+void LatencyHistogram::observe(std::chrono::microseconds latency)
+{
+    auto microseconds = static_cast<std::uint64_t>(std::max<std::chrono::microseconds::rep>(latency.count(), 0));
+    auto &bounds = bucketBounds();
+    auto index = static_cast<size_t>(std::lower_bound(bounds.begin(), bounds.end(), microseconds) - bounds.begin());
+    _buckets[index].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(microseconds, std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,41 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace nn2048
+{
+
+/// Latency distribution in fixed exponential buckets. Observations only
+/// increment relaxed atomics, so recording never waits for readers. Values
+/// read while observations go on may be a few observations apart.
+class LatencyHistogram
+{
+public:
+    static const size_t bucketCount = 12;
+
+    LatencyHistogram();
+
+    /// Upper bounds of all buckets but the last, unbounded one, in microseconds
+    static const std::array<std::uint64_t, bucketCount - 1> &bucketBounds();
+
+    void observe(std::chrono::microseconds latency);
+
+    /// Observations in the bucket alone, not cumulative
+    std::uint64_t bucket(size_t index) const { return _buckets[index].load(std::memory_order_relaxed); }
+    std::uint64_t count() const { return _count.load(std::memory_order_relaxed); }
+    std::uint64_t sumMicroseconds() const { return _sum.load(std::memory_order_relaxed); }
+
+private:
+    std::array<std::atomic<std::uint64_t>, bucketCount> _buckets;
+    std::atomic<std::uint64_t> _count;
+    std::atomic<std::uint64_t> _sum;
+};
+
+}
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,114 @@
+#ifndef LOCKFREEQUEUE_H
+#define LOCKFREEQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace nn2048
+{
+
+/// Bounded multi-producer multi-consumer queue without locks. Every cell
+/// carries a sequence number telling whether it is free for the producer or
+/// filled for the consumer of the current lap, so threads only contend on
+/// the enqueue and dequeue positions. Capacity is rounded up to power of two.
+template<typename T>
+class LockFreeQueue
+{
+public:
+    explicit LockFreeQueue(size_t capacity);
+
+    LockFreeQueue(const LockFreeQueue &) = delete;
+    LockFreeQueue &operator = (const LockFreeQueue &) = delete;
+
+    /// Returns false without taking the value when queue is full
+    bool tryPush(T &&value);
+    /// Returns false when queue is empty
+    bool tryPop(T &value);
+
+    size_t capacity() const { return _mask + 1; }
+    /// Approximate number of queued values
+    size_t size() const;
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> _cells;
+    size_t _mask;
+    alignas(64) std::atomic<size_t> _enqueuePosition;
+    alignas(64) std::atomic<size_t> _dequeuePosition;
+};
+
+template<typename T>
+LockFreeQueue<T>::LockFreeQueue(size_t capacity):
+    _enqueuePosition(0),
+    _dequeuePosition(0)
+{
+    size_t roundedCapacity = 2;
+    while (roundedCapacity < capacity)
+        roundedCapacity *= 2;
+    _cells.reset(new Cell[roundedCapacity]);
+    _mask = roundedCapacity - 1;
+    for (size_t i = 0; i < roundedCapacity; ++i)
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template<typename T>
+bool LockFreeQueue<T>::tryPush(T &&value)
+{
+    size_t position = _enqueuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        auto &cell = _cells[position & _mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+        if (difference == 0) {
+            if (_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                cell.value = std::move(value);
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = _enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<typename T>
+bool LockFreeQueue<T>::tryPop(T &value)
+{
+    size_t position = _dequeuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        auto &cell = _cells[position & _mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+        if (difference == 0) {
+            if (_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                value = std::move(cell.value);
+                cell.sequence.store(position + _mask + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = _dequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<typename T>
+size_t LockFreeQueue<T>::size() const
+{
+    size_t enqueued = _enqueuePosition.load(std::memory_order_relaxed);
+    size_t dequeued = _dequeuePosition.load(std::memory_order_relaxed);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
+}
+
+#endif // LOCKFREEQUEUE_H
@@ -0,0 +1,217 @@
+#include "Logger.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include "Defaults.h"
+
+namespace nn2048
+{
+
+namespace
+{
+
+const char *levelNames[] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+
+void formatEntry(const Logger::Entry &entry, std::string &out)
+{
+    auto time = std::chrono::system_clock::to_time_t(entry.time);
+    auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(entry.time.time_since_epoch()).count() % 1000;
+    std::tm utcTime;
+    gmtime_r(&time, &utcTime);
+    char timestamp[32];
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &utcTime);
+    char fraction[8];
+    std::snprintf(fraction, sizeof(fraction), ".%03d", static_cast<int>(milliseconds));
+
+    out += timestamp;
+    out += fraction;
+    out += " ";
+    out += Logger::levelName(entry.level);
+    out += " [";
+    out += std::to_string(entry.thread);
+    out += "] ";
+    out += entry.message;
+    out += "\n";
+}
+
+}
+
+std::atomic<int> Logger::_level(static_cast<int>(LogLevel::Info));
+thread_local Logger::ThreadBufferHolder Logger::_threadBuffer;
+
+Logger::ThreadBuffer::ThreadBuffer(unsigned thread):
+    entries(DefaultLogBufferSize),
+    thread(thread),
+    closed(false)
+{}
+
+Logger::ThreadBufferHolder::~ThreadBufferHolder()
+{
+    if (buffer)
+        buffer->closed.store(true, std::memory_order_release);
+}
+
+Logger &Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+const char *Logger::levelName(LogLevel level)
+{
+    return levelNames[static_cast<int>(level)];
+}
+
+bool Logger::tryParseLevel(const std::string &name, LogLevel &level)
+{
+    std::string upperName(name);
+    std::transform(upperName.begin(), upperName.end(), upperName.begin(), [] (char c) {
+        return static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    });
+    for (int i = 0; i <= static_cast<int>(LogLevel::Error); ++i) {
+        if (upperName == levelNames[i]) {
+            level = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+Logger::Logger():
+    _flushRequested(0),
+    _flushCompleted(0),
+    _stopping(false),
+    _droppedCount(0),
+    _reportedDropCount(0)
+{
+    _flusher = std::thread(&Logger::flushLoop, this);
+}
+
+Logger::~Logger()
+{
+    {
+        std::lock_guard<std::mutex> lock(_flushMutex);
+        _stopping = true;
+    }
+    _flushCondition.notify_all();
+    _flusher.join();
+}
+
+void Logger::write(LogLevel level, std::string message)
+{
+    Entry entry { level, std::chrono::system_clock::now(), 0, std::move(message) };
+    auto &buffer = threadBuffer();
+    entry.thread = buffer.thread;
+    while (!buffer.entries.tryPush(std::move(entry))) {
+        if (level == LogLevel::Debug) {
+            ++_droppedCount;
+            return;
+        }
+        // Flusher is gone only while the logger is destroyed, the line cannot be written then
+        if (!waitForFlush()) {
+            ++_droppedCount;
+            return;
+        }
+    }
+}
+
+void Logger::flush()
+{
+    waitForFlush();
+}
+
+bool Logger::waitForFlush()
+{
+    std::unique_lock<std::mutex> lock(_flushMutex);
+    auto request = ++_flushRequested;
+    _flushCondition.notify_one();
+    _flushedCondition.wait(lock, [this, request] () { return _stopping || _flushCompleted >= request; });
+    return !_stopping;
+}
+
+Logger::ThreadBuffer &Logger::threadBuffer()
+{
+    if (_threadBuffer.buffer)
+        return *_threadBuffer.buffer;
+
+    // First line of this thread, the buffer stays registered until drained after the thread ends
+    std::lock_guard<std::mutex> lock(_buffersMutex);
+    static unsigned threadCount = 0;
+    _threadBuffer.buffer = std::make_shared<ThreadBuffer>(threadCount++);
+    _buffers.push_back(_threadBuffer.buffer);
+    return *_threadBuffer.buffer;
+}
+
+void Logger::flushLoop()
+{
+    std::vector<Entry> batch;
+    while (true) {
+        std::uint64_t request;
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(_flushMutex);
+            _flushCondition.wait_for(lock, std::chrono::milliseconds(DefaultLogFlushInterval), [this] () {
+                return _stopping || _flushRequested > _flushCompleted;
+            });
+            request = _flushRequested;
+            stopping = _stopping;
+        }
+
+        // Threads may log more while a batch is written
+        while (writeBuffered(batch))
+            continue;
+
+        {
+            std::lock_guard<std::mutex> lock(_flushMutex);
+            _flushCompleted = request;
+        }
+        _flushedCondition.notify_all();
+        if (stopping)
+            return;
+    }
+}
+
+bool Logger::writeBuffered(std::vector<Entry> &batch)
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(_buffersMutex);
+        // Buffer of finished thread gets no more lines, it is drained for the last time below
+        for (auto it = _buffers.begin(); it != _buffers.end();) {
+            buffers.push_back(*it);
+            if ((*it)->closed.load(std::memory_order_acquire))
+                it = _buffers.erase(it);
+            else ++it;
+        }
+    }
+
+    batch.clear();
+    Entry entry;
+    for (auto &buffer: buffers)
+        while (buffer->entries.tryPop(entry))
+            batch.push_back(std::move(entry));
+
+    auto dropped = _droppedCount.load();
+    if (batch.empty() && dropped == _reportedDropCount)
+        return false;
+
+    // Threads are drained one after another, lines are merged back into time order
+    std::stable_sort(batch.begin(), batch.end(), [] (const Entry &first, const Entry &second) {
+        return first.time < second.time;
+    });
+    std::string text;
+    for (auto &bufferedEntry: batch)
+        formatEntry(bufferedEntry, text);
+    if (dropped != _reportedDropCount) {
+        formatEntry({ LogLevel::Warning, std::chrono::system_clock::now(), 0,
+                      std::to_string(dropped - _reportedDropCount) + " debug lines dropped, log buffer was full" }, text);
+        _reportedDropCount = dropped;
+    }
+    std::clog << text;
+    std::clog.flush();
+    return !batch.empty();
+}
+
+}
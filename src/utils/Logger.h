@@ -0,0 +1,157 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LockFreeQueue.h"
+
+/// Lowest level compiled in, debug lines are removed from release builds
+#ifndef NN2048_MIN_LOG_LEVEL
+#ifdef NDEBUG
+#define NN2048_MIN_LOG_LEVEL 1
+#else
+#define NN2048_MIN_LOG_LEVEL 0
+#endif
+#endif
+
+/// Streams one log line, the message is not even formatted when the level is filtered.
+/// Expression form keeps the macro safe inside unbraced if/else.
+#define NN2048_LOG(level) \
+    !nn2048::Logger::isEnabled(nn2048::LogLevel::level) ? (void) 0 : \
+    nn2048::LogLineVoidify() & nn2048::LogLine(nn2048::LogLevel::level).stream()
+
+#define LOG_DEBUG NN2048_LOG(Debug)
+#define LOG_INFO NN2048_LOG(Info)
+#define LOG_WARNING NN2048_LOG(Warning)
+#define LOG_ERROR NN2048_LOG(Error)
+
+namespace nn2048
+{
+
+enum class LogLevel
+{
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+/// Process wide logger. Every thread appends lines to its own lock-free
+/// buffer, a background thread collects them in time order and writes them
+/// to std::clog in batches, so logging threads never share a stream lock or
+/// wait for a flush. Debug lines are dropped when the thread buffer is full,
+/// other levels wait for the flusher instead of being lost.
+class Logger
+{
+public:
+    struct Entry
+    {
+        LogLevel level;
+        std::chrono::system_clock::time_point time;
+        unsigned thread;
+        std::string message;
+    };
+
+    static Logger &instance();
+
+    static bool isEnabled(LogLevel level)
+    {
+        return static_cast<int>(level) >= NN2048_MIN_LOG_LEVEL
+                && static_cast<int>(level) >= _level.load(std::memory_order_relaxed);
+    }
+    static void setLevel(LogLevel level) { _level.store(static_cast<int>(level), std::memory_order_relaxed); }
+    static LogLevel level() { return static_cast<LogLevel>(_level.load(std::memory_order_relaxed)); }
+
+    static const char *levelName(LogLevel level);
+    /// Accepts level names as printed in log lines, case insensitive
+    static bool tryParseLevel(const std::string &name, LogLevel &level);
+
+    /// Writes remaining lines before joining the flusher
+    ~Logger();
+
+    Logger(const Logger &) = delete;
+    Logger &operator = (const Logger &) = delete;
+
+    void write(LogLevel level, std::string message);
+    /// Blocks until lines written so far by all threads are out
+    void flush();
+
+    std::uint64_t droppedCount() const { return _droppedCount; }
+
+protected:
+    struct ThreadBuffer
+    {
+        explicit ThreadBuffer(unsigned thread);
+
+        LockFreeQueue<Entry> entries;
+        unsigned thread;
+        std::atomic<bool> closed;
+    };
+
+    /// Marks the buffer closed when its thread ends
+    struct ThreadBufferHolder
+    {
+        std::shared_ptr<ThreadBuffer> buffer;
+
+        ~ThreadBufferHolder();
+    };
+
+    Logger();
+
+    ThreadBuffer &threadBuffer();
+    /// Requests a flush and waits for it, returns false when the logger is stopping
+    bool waitForFlush();
+    void flushLoop();
+    /// Writes buffered lines, returns false when there were none
+    bool writeBuffered(std::vector<Entry> &batch);
+
+private:
+    static std::atomic<int> _level;
+    static thread_local ThreadBufferHolder _threadBuffer;
+
+    std::vector<std::shared_ptr<ThreadBuffer>> _buffers;
+    std::mutex _buffersMutex;
+
+    std::mutex _flushMutex;
+    std::condition_variable _flushCondition;
+    std::condition_variable _flushedCondition;
+    std::uint64_t _flushRequested;
+    std::uint64_t _flushCompleted;
+    bool _stopping;
+
+    std::atomic<std::uint64_t> _droppedCount;
+    std::uint64_t _reportedDropCount;
+    std::thread _flusher;
+};
+
+/// Turns the streamed line into void for the conditional in NN2048_LOG
+struct LogLineVoidify
+{
+    void operator & (std::ostream &) {}
+};
+
+/// Collects one line and hands it to the logger when destroyed
+class LogLine
+{
+public:
+    explicit LogLine(LogLevel level): _level(level) {}
+    ~LogLine() { Logger::instance().write(_level, _stream.str()); }
+
+    std::ostream &stream() { return _stream; }
+
+private:
+    LogLevel _level;
+    std::ostringstream _stream;
+};
+
+}
+
+#endif // LOGGER_H
@@ -0,0 +1,119 @@
+#include "MergeManifest.h"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <boost/filesystem.hpp>
+#include <json/json.h>
+#include "Fnv1a.h"
+
+namespace nn2048
+{
+
+static const std::string FilesKey = "files";
+static const std::string OutputStatesKey = "outputStates";
+static const std::string NameKey = "name";
+static const std::string SizeKey = "size";
+static const std::string ModificationTimeKey = "mtime";
+static const std::string HashKey = "hash";
+
+void MergeManifest::load(const std::string &fileName)
+{
+    std::ifstream file(fileName);
+    if (!file)
+        throw std::runtime_error("Cannot open manifest " + fileName);
+    auto json = Json::Value();
+    file >> json;
+
+    if (json.type() != Json::objectValue || !json.isMember(FilesKey) || json[FilesKey].type() != Json::arrayValue)
+        throw std::runtime_error("Manifest has to be an object with files array");
+    if (!json.isMember(OutputStatesKey))
+        throw std::runtime_error("Manifest misses output state count");
+    _outputStateCount = json[OutputStatesKey].asUInt64();
+
+    for (auto &entryJson: json[FilesKey]) {
+        if (!entryJson.isMember(NameKey) || !entryJson.isMember(SizeKey) ||
+            !entryJson.isMember(ModificationTimeKey) || !entryJson.isMember(HashKey))
+            throw std::runtime_error("Manifest entry misses one of name, size, mtime and hash fields");
+        ManifestEntry entry;
+        entry.name = entryJson[NameKey].asString();
+        entry.size = entryJson[SizeKey].asUInt64();
+        entry.modificationTime = static_cast<std::time_t>(entryJson[ModificationTimeKey].asInt64());
+        entry.hash = entryJson[HashKey].asString();
+        add(entry);
+    }
+}
+
+bool MergeManifest::save(const std::string &fileName) const
+{
+    auto json = Json::Value(Json::objectValue);
+    auto filesJson = Json::Value(Json::arrayValue);
+    for (auto &item: _entries) {
+        auto &entry = item.second;
+        auto entryJson = Json::Value(Json::objectValue);
+        entryJson[NameKey] = entry.name;
+        entryJson[SizeKey] = static_cast<Json::UInt64>(entry.size);
+        entryJson[ModificationTimeKey] = static_cast<Json::Int64>(entry.modificationTime);
+        entryJson[HashKey] = entry.hash;
+        filesJson.append(entryJson);
+    }
+    json[FilesKey] = filesJson;
+    json[OutputStatesKey] = static_cast<Json::UInt64>(_outputStateCount);
+
+    // Interrupted save must not leave a manifest which does not match the output
+    auto temporaryFileName = fileName + ".tmp";
+    {
+        std::ofstream file(temporaryFileName);
+        if (!file)
+            return false;
+        Json::StreamWriterBuilder builder;
+        std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+        writer->write(json, &file);
+        if (!file)
+            return false;
+    }
+    return std::rename(temporaryFileName.c_str(), fileName.c_str()) == 0;
+}
+
+ManifestEntry MergeManifest::describe(const std::string &fileName)
+{
+    boost::filesystem::path path(fileName);
+    ManifestEntry entry;
+    entry.name = path.filename().string();
+    entry.size = boost::filesystem::file_size(path);
+    entry.modificationTime = boost::filesystem::last_write_time(path);
+    return entry;
+}
+
+std::string MergeManifest::hashFile(const std::string &fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Cannot open file " + fileName);
+
+    Fnv1a hash;
+    char buffer[65536];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+        hash.update(buffer, static_cast<size_t>(file.gcount()));
+
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash.value()));
+    return hex;
+}
+
+bool MergeManifest::contains(const ManifestEntry &entry) const
+{
+    auto found = _entries.find(entry.name);
+    return found != _entries.end() &&
+           found->second.size == entry.size &&
+           found->second.modificationTime == entry.modificationTime;
+}
+
+void MergeManifest::add(const ManifestEntry &entry)
+{
+    _entries[entry.name] = entry;
+    if (!entry.hash.empty())
+        _hashes.insert(entry.hash);
+}
+
+}
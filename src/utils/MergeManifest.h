@@ -0,0 +1,65 @@
+#ifndef MERGEMANIFEST_H
+#define MERGEMANIFEST_H
+
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <set>
+#include <string>
+
+namespace nn2048
+{
+
+struct ManifestEntry
+{
+    /// File name without directory
+    std::string name;
+    std::uintmax_t size;
+    std::time_t modificationTime;
+    /// FNV-1a hash of file content as hex string, empty when no other file
+    /// had the same size, copies cannot exist then
+    std::string hash;
+};
+
+/// Replay files already ingested into a merged output. Stored as json next
+/// to the output file, so later merges can append new files only. State
+/// count of the output is stored too, an output which does not match it was
+/// extended by a merge which did not get to save its manifest.
+class MergeManifest
+{
+public:
+    static std::string fileNameFor(const std::string &outputFileName) { return outputFileName + ".manifest"; }
+
+    /// Throws std::runtime_error when manifest cannot be read
+    void load(const std::string &fileName);
+    /// Replaces the file atomically
+    bool save(const std::string &fileName) const;
+
+    /// Name, size and modification time of the file, hash is left empty.
+    /// Throws boost::filesystem::filesystem_error.
+    static ManifestEntry describe(const std::string &fileName);
+    /// Throws std::runtime_error when file cannot be read
+    static std::string hashFile(const std::string &fileName);
+
+    /// True when file with the same name, size and modification time was ingested
+    bool contains(const ManifestEntry &entry) const;
+    bool containsName(const std::string &name) const { return _entries.count(name) == 1; }
+    bool containsHash(const std::string &hash) const { return _hashes.count(hash) == 1; }
+    /// Replaces entry of the same name
+    void add(const ManifestEntry &entry);
+
+    size_t size() const { return _entries.size(); }
+    const std::map<std::string, ManifestEntry> &entries() const { return _entries; }
+
+    std::uint64_t outputStateCount() const { return _outputStateCount; }
+    void setOutputStateCount(std::uint64_t stateCount) { _outputStateCount = stateCount; }
+
+private:
+    std::map<std::string, ManifestEntry> _entries;
+    std::set<std::string> _hashes;
+    std::uint64_t _outputStateCount = 0;
+};
+
+}
+
+#endif // MERGEMANIFEST_H
@@ -0,0 +1,109 @@
+#include "MinibatchPipeline.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace nn2048
+{
+
+MinibatchPipeline::MinibatchPipeline(const ReplayMemory &replayMemory, size_t batchSize, const RandomStream &random):
+    _replayMemory(replayMemory),
+    _random(random),
+    _consumerBuffer(bufferCount - 1),
+    _consumerHoldsBuffer(false),
+    _stallCount(0),
+    _stopping(false)
+{
+    auto &states = _replayMemory.states();
+    if (states.empty())
+        throw std::invalid_argument("Minibatch pipeline needs non-empty replay memory");
+    if (batchSize == 0)
+        throw std::invalid_argument("Minibatch pipeline batch size cannot be 0");
+
+    _batchSize = std::min(batchSize, states.size());
+    _order.resize(states.size());
+    std::iota(_order.begin(), _order.end(), 0);
+
+    // Buffers are allocated once, producer only overwrites them
+    auto inputCount = static_cast<unsigned>(states.front()->boardSignal().size());
+    for (auto &buffer: _buffers) {
+        buffer.inputCount = inputCount;
+        buffer.inputs.resize(_batchSize * inputCount);
+        buffer.targets.resize(_batchSize);
+        buffer.actions.resize(_batchSize);
+    }
+    std::fill(_ready, _ready + bufferCount, false);
+
+    _producer = std::thread(&MinibatchPipeline::produce, this);
+}
+
+MinibatchPipeline::~MinibatchPipeline()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _condition.notify_all();
+    _producer.join();
+}
+
+const MinibatchPipeline::Minibatch &MinibatchPipeline::next()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_consumerHoldsBuffer) {
+        _ready[_consumerBuffer] = false;
+        _consumerHoldsBuffer = false;
+        _condition.notify_all();
+    }
+
+    // Buffers are consumed in the same order as they are filled
+    _consumerBuffer = (_consumerBuffer + 1) % bufferCount;
+    if (!_ready[_consumerBuffer]) {
+        ++_stallCount;
+        _condition.wait(lock, [this] () { return _ready[_consumerBuffer]; });
+    }
+    _consumerHoldsBuffer = true;
+    return _buffers[_consumerBuffer];
+}
+
+void MinibatchPipeline::produce()
+{
+    unsigned buffer = 0;
+    while (true) {
+        std::shuffle(_order.begin(), _order.end(), _random);
+        for (size_t first = 0; first < _order.size(); first += _batchSize) {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock, [this, buffer] () { return _stopping || !_ready[buffer]; });
+                if (_stopping)
+                    return;
+            }
+
+            // Buffer is not ready, so consumer does not touch it
+            fill(_buffers[buffer], first, std::min(first + _batchSize, _order.size()));
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _ready[buffer] = true;
+            }
+            _condition.notify_all();
+            buffer = (buffer + 1) % bufferCount;
+        }
+    }
+}
+
+void MinibatchPipeline::fill(Minibatch &batch, size_t first, size_t last)
+{
+    auto &states = _replayMemory.states();
+    batch.size = last - first;
+    batch.lastInEpoch = last == _order.size();
+    for (size_t i = 0; i < batch.size; ++i) {
+        auto &state = *states[_order[first + i]];
+        auto &signal = state.boardSignal();
+        std::copy(signal.begin(), signal.end(), batch.inputs.begin() + static_cast<std::ptrdiff_t>(i * batch.inputCount));
+        batch.targets[i] = state.discountedReturn();
+        batch.actions[i] = state.takenAction();
+    }
+}
+
+}
@@ -0,0 +1,77 @@
+#ifndef MINIBATCHPIPELINE_H
+#define MINIBATCHPIPELINE_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <GameCore.h>
+#include "RandomService.h"
+#include "ReplayMemory.h"
+
+namespace nn2048
+{
+
+/// Prepares shuffled minibatches of replay states on a background thread.
+/// Two preallocated buffers are used in turns: the producer fills one while
+/// the consumer trains on the other, so the next batch is usually ready
+/// before it is requested. Epochs follow each other without a gap, every
+/// epoch is a new permutation of all states.
+class MinibatchPipeline
+{
+public:
+    struct Minibatch
+    {
+        /// Board signals of all samples, one after another
+        std::vector<double> inputs;
+        std::vector<double> targets;
+        std::vector<Game2048Core::Direction> actions;
+        size_t size = 0;
+        unsigned inputCount = 0;
+        bool lastInEpoch = false;
+
+        const double *input(size_t index) const { return &inputs[index * inputCount]; }
+    };
+
+    /// Replay memory has to stay unchanged while the pipeline exists. Batch size
+    /// bounds buffer memory, so it has to be positive.
+    MinibatchPipeline(const ReplayMemory &replayMemory, size_t batchSize, const RandomStream &random);
+    ~MinibatchPipeline();
+
+    MinibatchPipeline(const MinibatchPipeline &) = delete;
+    MinibatchPipeline &operator = (const MinibatchPipeline &) = delete;
+
+    /// Returns next prepared minibatch and releases the previous one for refill.
+    /// The returned batch is valid until the next call.
+    const Minibatch &next();
+
+    /// Number of next() calls which had to wait for the producer
+    unsigned long stallCount() const { return _stallCount; }
+
+protected:
+    void produce();
+    void fill(Minibatch &batch, size_t first, size_t last);
+
+private:
+    static const unsigned bufferCount = 2;
+
+    const ReplayMemory &_replayMemory;
+    size_t _batchSize;
+    RandomStream _random;
+    std::vector<size_t> _order;
+
+    Minibatch _buffers[bufferCount];
+    bool _ready[bufferCount];
+    unsigned _consumerBuffer;
+    bool _consumerHoldsBuffer;
+    unsigned long _stallCount;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping;
+    std::thread _producer;
+};
+
+}
+
+#endif // MINIBATCHPIPELINE_H
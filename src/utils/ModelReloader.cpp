@@ -0,0 +1,142 @@
+#include "ModelReloader.h"
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <boost/filesystem.hpp>
+#include <NetworkSerializer.h>
+#include <GameCore.h>
+#include "FannBoardEvaluator.h"
+#include "Logger.h"
+#include "NetworkBoardEvaluator.h"
+#include "NTupleNetwork.h"
+#include "PerceptronBoardEvaluator.h"
+
+namespace nn2048
+{
+
+ModelReloader::ModelReloader(const std::string &fileName, ReloadableBoardEvaluator &evaluator, std::chrono::seconds pollInterval):
+    _fileName(fileName),
+    _evaluator(evaluator),
+    _pollInterval(pollInterval),
+    _stopping(false)
+{
+    // Evaluator already holds the model from this file
+    readFileVersion(_loadedVersion);
+    _observedVersion = _loadedVersion;
+    _watcher = std::thread(&ModelReloader::watch, this);
+}
+
+ModelReloader::~ModelReloader()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _condition.notify_all();
+    _watcher.join();
+}
+
+std::shared_ptr<const BoardEvaluator> ModelReloader::load(const std::string &fileName)
+{
+    std::shared_ptr<const BoardEvaluator> model;
+    if (NTupleNetwork::isNTupleNetworkFile(fileName)) {
+        model = NTupleNetwork::load(fileName);
+    } else if (PerceptronBoardEvaluator::isFannNetworkFile(fileName)) {
+        model = loadFann(fileName);
+    } else {
+        std::ifstream file(fileName);
+        if (!file.is_open())
+            throw std::runtime_error("Neural network file could not be opened (" + fileName + ")");
+        model = std::make_shared<NetworkBoardEvaluator>(NeuralNetwork::NetworkSerializer::deserialize(file));
+    }
+    validate(*model);
+    return model;
+}
+
+std::shared_ptr<const BoardEvaluator> ModelReloader::loadFann(const std::string &fileName)
+{
+    auto network = std::make_unique<FANN::neural_net>(fileName);
+    auto inputCount = network->get_num_input();
+    if (inputCount == 0)
+        throw std::runtime_error("FANN network could not be loaded (" + fileName + ")");
+    else if (!PerceptronBoardEvaluator::isSupportedInputCount(inputCount))
+        throw std::runtime_error("Network input count " + std::to_string(inputCount) + " matches no board encoding");
+
+    try {
+        return std::make_shared<PerceptronBoardEvaluator>(MultilayerPerceptron::fromFann(*network));
+    } catch (std::runtime_error &exception) {
+        // Networks with shortcuts or other activations still run through FANN
+        LOG_INFO << "Network served by FANN: " << exception.what();
+        return std::make_shared<FannBoardEvaluator>(std::move(network));
+    }
+}
+
+bool ModelReloader::reload()
+{
+    FileVersion version;
+    readFileVersion(version);
+    try {
+        auto model = load(_fileName);
+        _evaluator.replace(std::move(model));
+        LOG_INFO << "Model reloaded from " << _fileName << " (version " << _evaluator.version() << ")";
+    } catch (std::exception &exception) {
+        LOG_WARNING << "Model reload failed, keeping current model: " << exception.what();
+        // Same file is not retried until it changes again
+        _loadedVersion = version;
+        return false;
+    }
+    _loadedVersion = version;
+    return true;
+}
+
+bool ModelReloader::FileVersion::operator == (const FileVersion &other) const
+{
+    return size == other.size && modificationTime == other.modificationTime;
+}
+
+void ModelReloader::validate(const BoardEvaluator &model)
+{
+    // Empty board and a board with a few tiles have to give finite move values
+    std::vector<PackedBoard> boards { 0x0, 0x1200003400000011 };
+    std::vector<double> values;
+    model.evaluateMoves(boards, values);
+    if (values.size() != boards.size() * static_cast<size_t>(Game2048Core::Direction::Total))
+        throw std::runtime_error("Model gives unexpected number of move values");
+    for (auto value: values) {
+        if (!std::isfinite(value))
+            throw std::runtime_error("Model gives non-finite move values");
+    }
+}
+
+bool ModelReloader::readFileVersion(FileVersion &version) const
+{
+    boost::system::error_code error;
+    auto size = boost::filesystem::file_size(_fileName, error);
+    if (error)
+        return false;
+    auto modificationTime = boost::filesystem::last_write_time(_fileName, error);
+    if (error)
+        return false;
+    version.size = size;
+    version.modificationTime = modificationTime;
+    return true;
+}
+
+void ModelReloader::watch()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_condition.wait_for(lock, _pollInterval, [this] () { return _stopping; })) {
+        FileVersion version;
+        if (!readFileVersion(version))
+            continue;
+        bool isStable = version == _observedVersion;
+        _observedVersion = version;
+        if (isStable && version != _loadedVersion) {
+            lock.unlock();
+            reload();
+            lock.lock();
+        }
+    }
+}
+
+}
@@ -0,0 +1,67 @@
+#ifndef MODELRELOADER_H
+#define MODELRELOADER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "ReloadableBoardEvaluator.h"
+
+namespace nn2048
+{
+
+/// Watches model file and swaps the model of ReloadableBoardEvaluator when
+/// the file changes. Loading and validation run on the watcher thread, a model
+/// which fails to load is reported and the current one is kept. File is
+/// loaded once its size and modification time stay the same for one poll
+/// interval, so a model being copied is not picked up half written.
+class ModelReloader
+{
+public:
+    ModelReloader(const std::string &fileName, ReloadableBoardEvaluator &evaluator, std::chrono::seconds pollInterval);
+    ~ModelReloader();
+
+    ModelReloader(const ModelReloader &) = delete;
+    ModelReloader &operator = (const ModelReloader &) = delete;
+
+    /// Loads n-tuple network, FANN network or json neural network and checks
+    /// that it evaluates boards. Throws std::runtime_error on failure.
+    static std::shared_ptr<const BoardEvaluator> load(const std::string &fileName);
+
+protected:
+    struct FileVersion
+    {
+        std::uintmax_t size = 0;
+        std::time_t modificationTime = 0;
+
+        bool operator == (const FileVersion &other) const;
+        bool operator != (const FileVersion &other) const { return !(*this == other); }
+    };
+
+    /// Returns false and keeps the current model on failure
+    bool reload();
+    static std::shared_ptr<const BoardEvaluator> loadFann(const std::string &fileName);
+    static void validate(const BoardEvaluator &model);
+    bool readFileVersion(FileVersion &version) const;
+    void watch();
+
+private:
+    std::string _fileName;
+    ReloadableBoardEvaluator &_evaluator;
+    std::chrono::seconds _pollInterval;
+    FileVersion _loadedVersion;
+    FileVersion _observedVersion;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping;
+    std::thread _watcher;
+};
+
+}
+
+#endif // MODELRELOADER_H
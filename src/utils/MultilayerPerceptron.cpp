@@ -0,0 +1,233 @@
+#include "MultilayerPerceptron.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace nn2048
+{
+
+namespace
+{
+
+MultilayerPerceptron::Activation toActivation(FANN::activation_function_enum function)
+{
+    switch (function)
+    {
+    case FANN::LINEAR:
+        return MultilayerPerceptron::Activation::Linear;
+    case FANN::SIGMOID_SYMMETRIC:
+        return MultilayerPerceptron::Activation::SigmoidSymmetric;
+    case FANN::SIGMOID:
+        return MultilayerPerceptron::Activation::Sigmoid;
+    default:
+        throw std::runtime_error("Network uses activation function not supported by batch optimizers");
+    }
+}
+
+}
+
+MultilayerPerceptron MultilayerPerceptron::fromFann(FANN::neural_net &network)
+{
+    unsigned layerCount = network.get_num_layers();
+    if (layerCount < 2)
+        throw std::runtime_error("Network needs at least input and output layer");
+    std::vector<unsigned> layerSizes(layerCount);
+    std::vector<unsigned> biasCounts(layerCount);
+    network.get_layer_array(&layerSizes[0]);
+    network.get_bias_array(&biasCounts[0]);
+
+    // FANN numbers neurons through all layers, bias neuron closes every layer
+    std::vector<unsigned> neuronOffsets(layerCount, 0);
+    for (unsigned i = 1; i < layerCount; ++i)
+        neuronOffsets[i] = neuronOffsets[i - 1] + layerSizes[i - 1] + biasCounts[i - 1];
+
+    MultilayerPerceptron perceptron;
+    size_t weightCount = 0;
+    for (unsigned i = 1; i < layerCount; ++i) {
+        if (biasCounts[i - 1] != 1)
+            throw std::runtime_error("Every non output layer has to have one bias neuron");
+        Layer layer;
+        layer.inputCount = layerSizes[i - 1];
+        layer.outputCount = layerSizes[i];
+        layer.activation = toActivation(network.get_activation_function(static_cast<int>(i), 0));
+        layer.steepness = network.get_activation_steepness(static_cast<int>(i), 0);
+        layer.weightOffset = weightCount;
+        weightCount += static_cast<size_t>(layer.outputCount) * (layer.inputCount + 1);
+        perceptron._layers.push_back(layer);
+    }
+    perceptron._parameters.assign(weightCount, 0.0);
+
+    std::vector<FANN::connection> connections(network.get_total_connections());
+    network.get_connection_array(&connections[0]);
+    if (connections.size() != weightCount)
+        throw std::runtime_error("Network is not fully connected layer by layer");
+    for (auto &connection: connections) {
+        unsigned layerIndex = 1;
+        while (layerIndex + 1 < layerCount && connection.to_neuron >= neuronOffsets[layerIndex + 1])
+            ++layerIndex;
+        auto &layer = perceptron._layers[layerIndex - 1];
+        unsigned row = connection.to_neuron - neuronOffsets[layerIndex];
+        unsigned column = connection.from_neuron - neuronOffsets[layerIndex - 1];
+        if (connection.from_neuron < neuronOffsets[layerIndex - 1] || row >= layer.outputCount || column > layer.inputCount)
+            throw std::runtime_error("Network has connections skipping layers");
+        perceptron._parameters[layer.weightOffset + static_cast<size_t>(row) * (layer.inputCount + 1) + column] = connection.weight;
+    }
+    return perceptron;
+}
+
+void MultilayerPerceptron::toFann(FANN::neural_net &network) const
+{
+    unsigned layerCount = network.get_num_layers();
+    std::vector<unsigned> layerSizes(layerCount);
+    std::vector<unsigned> biasCounts(layerCount);
+    network.get_layer_array(&layerSizes[0]);
+    network.get_bias_array(&biasCounts[0]);
+    std::vector<unsigned> neuronOffsets(layerCount, 0);
+    for (unsigned i = 1; i < layerCount; ++i)
+        neuronOffsets[i] = neuronOffsets[i - 1] + layerSizes[i - 1] + biasCounts[i - 1];
+
+    std::vector<FANN::connection> connections(network.get_total_connections());
+    network.get_connection_array(&connections[0]);
+    for (auto &connection: connections) {
+        unsigned layerIndex = 1;
+        while (layerIndex + 1 < layerCount && connection.to_neuron >= neuronOffsets[layerIndex + 1])
+            ++layerIndex;
+        auto &layer = _layers[layerIndex - 1];
+        unsigned row = connection.to_neuron - neuronOffsets[layerIndex];
+        unsigned column = connection.from_neuron - neuronOffsets[layerIndex - 1];
+        connection.weight = _parameters[layer.weightOffset + static_cast<size_t>(row) * (layer.inputCount + 1) + column];
+    }
+    network.set_weight_array(&connections[0], static_cast<unsigned>(connections.size()));
+}
+
+MultilayerPerceptron::Workspace MultilayerPerceptron::createWorkspace() const
+{
+    Workspace workspace;
+    for (auto &layer: _layers) {
+        workspace.activations.emplace_back(layer.outputCount, 0.0);
+        workspace.deltas.emplace_back(layer.outputCount, 0.0);
+    }
+    return workspace;
+}
+
+const std::vector<double> &MultilayerPerceptron::forward(const double *input, Workspace &workspace) const
+{
+    auto &firstLayer = _layers.front();
+    auto &firstOutputs = workspace.activations.front();
+    for (unsigned j = 0; j < firstLayer.outputCount; ++j) {
+        const double *row = &_parameters[firstLayer.weightOffset + static_cast<size_t>(j) * (firstLayer.inputCount + 1)];
+        double sum = row[firstLayer.inputCount];
+        for (unsigned i = 0; i < firstLayer.inputCount; ++i)
+            sum += row[i] * input[i];
+        firstOutputs[j] = activate(firstLayer, sum);
+    }
+    return forwardHiddenLayers(workspace);
+}
+
+const std::vector<double> &MultilayerPerceptron::forwardOneHot(const unsigned *activeInputs, size_t activeCount,
+                                                               Workspace &workspace) const
+{
+    // First layer input is one-hot, so only active weight columns are summed
+    auto &firstLayer = _layers.front();
+    auto &firstOutputs = workspace.activations.front();
+    for (unsigned j = 0; j < firstLayer.outputCount; ++j) {
+        const double *row = &_parameters[firstLayer.weightOffset + static_cast<size_t>(j) * (firstLayer.inputCount + 1)];
+        double sum = row[firstLayer.inputCount];
+        for (size_t k = 0; k < activeCount; ++k)
+            sum += row[activeInputs[k]];
+        firstOutputs[j] = activate(firstLayer, sum);
+    }
+    return forwardHiddenLayers(workspace);
+}
+
+const std::vector<double> &MultilayerPerceptron::forwardHiddenLayers(Workspace &workspace) const
+{
+    for (size_t l = 1; l < _layers.size(); ++l) {
+        auto &layer = _layers[l];
+        auto &inputs = workspace.activations[l - 1];
+        auto &outputs = workspace.activations[l];
+        for (unsigned j = 0; j < layer.outputCount; ++j) {
+            const double *row = &_parameters[layer.weightOffset + static_cast<size_t>(j) * (layer.inputCount + 1)];
+            double sum = row[layer.inputCount];
+            for (unsigned i = 0; i < layer.inputCount; ++i)
+                sum += row[i] * inputs[i];
+            outputs[j] = activate(layer, sum);
+        }
+    }
+    return workspace.activations.back();
+}
+
+void MultilayerPerceptron::backwardOneHot(const unsigned *activeInputs, size_t activeCount, const double *targets,
+                                          const bool *outputMask, Workspace &workspace, std::vector<double> &gradient) const
+{
+    auto &lastLayer = _layers.back();
+    auto &outputs = workspace.activations.back();
+    auto &outputDeltas = workspace.deltas.back();
+    for (unsigned j = 0; j < lastLayer.outputCount; ++j)
+        outputDeltas[j] = outputMask[j] ? (outputs[j] - targets[j]) * derivative(lastLayer, outputs[j]) : 0.0;
+
+    for (size_t l = _layers.size() - 1; l > 0; --l) {
+        auto &layer = _layers[l];
+        auto &deltas = workspace.deltas[l];
+        auto &inputs = workspace.activations[l - 1];
+        auto &inputDeltas = workspace.deltas[l - 1];
+        std::fill(inputDeltas.begin(), inputDeltas.end(), 0.0);
+
+        for (unsigned j = 0; j < layer.outputCount; ++j) {
+            if (deltas[j] == 0.0)
+                continue;
+            size_t rowOffset = layer.weightOffset + static_cast<size_t>(j) * (layer.inputCount + 1);
+            const double *row = &_parameters[rowOffset];
+            double *rowGradient = &gradient[rowOffset];
+            double delta = deltas[j];
+            for (unsigned i = 0; i < layer.inputCount; ++i) {
+                rowGradient[i] += delta * inputs[i];
+                inputDeltas[i] += delta * row[i];
+            }
+            rowGradient[layer.inputCount] += delta;
+        }
+
+        auto &inputLayer = _layers[l - 1];
+        for (unsigned i = 0; i < inputLayer.outputCount; ++i)
+            inputDeltas[i] *= derivative(inputLayer, inputs[i]);
+    }
+
+    auto &firstLayer = _layers.front();
+    auto &firstDeltas = workspace.deltas.front();
+    for (unsigned j = 0; j < firstLayer.outputCount; ++j) {
+        double *rowGradient = &gradient[firstLayer.weightOffset + static_cast<size_t>(j) * (firstLayer.inputCount + 1)];
+        for (size_t k = 0; k < activeCount; ++k)
+            rowGradient[activeInputs[k]] += firstDeltas[j];
+        rowGradient[firstLayer.inputCount] += firstDeltas[j];
+    }
+}
+
+double MultilayerPerceptron::activate(const Layer &layer, double sum) const
+{
+    switch (layer.activation)
+    {
+    case Activation::SigmoidSymmetric:
+        return std::tanh(layer.steepness * sum);
+    case Activation::Sigmoid:
+        return 1.0 / (1.0 + std::exp(-2.0 * layer.steepness * sum));
+    case Activation::Linear:
+    default:
+        return layer.steepness * sum;
+    }
+}
+
+double MultilayerPerceptron::derivative(const Layer &layer, double output) const
+{
+    switch (layer.activation)
+    {
+    case Activation::SigmoidSymmetric:
+        return layer.steepness * (1.0 - output * output);
+    case Activation::Sigmoid:
+        return 2.0 * layer.steepness * output * (1.0 - output);
+    case Activation::Linear:
+    default:
+        return layer.steepness;
+    }
+}
+
+}
@@ -0,0 +1,79 @@
+#ifndef MULTILAYERPERCEPTRON_H
+#define MULTILAYERPERCEPTRON_H
+
+#include <cstddef>
+#include <vector>
+#include <doublefann.h>
+#include <fann_cpp.h>
+
+namespace nn2048
+{
+
+/// Fully connected network with all weights kept in one flat array, so
+/// batch optimizers can work on parameters and gradients as plain vectors.
+/// Weights are exchanged with FANN networks of LAYER type.
+class MultilayerPerceptron
+{
+public:
+    enum class Activation
+    {
+        Linear,
+        SigmoidSymmetric,
+        Sigmoid
+    };
+
+    struct Layer
+    {
+        unsigned inputCount;
+        unsigned outputCount;
+        Activation activation;
+        double steepness;
+        /// Offset of the layer weights in parameters, rows of inputCount + 1 (bias last)
+        size_t weightOffset;
+    };
+
+    /// Per thread buffers used by forward and backward passes
+    struct Workspace
+    {
+        std::vector<std::vector<double>> activations;
+        std::vector<std::vector<double>> deltas;
+    };
+
+    /// Copies structure and weights, throws std::runtime_error for unsupported networks
+    static MultilayerPerceptron fromFann(FANN::neural_net &network);
+    /// Writes weights back to the network the perceptron was created from
+    void toFann(FANN::neural_net &network) const;
+
+    unsigned inputCount() const { return _layers.front().inputCount; }
+    unsigned outputCount() const { return _layers.back().outputCount; }
+    const std::vector<Layer> &layers() const { return _layers; }
+
+    std::vector<double> &parameters() { return _parameters; }
+    const std::vector<double> &parameters() const { return _parameters; }
+
+    Workspace createWorkspace() const;
+
+    /// Runs network on dense input of inputCount() values.
+    /// Returns output layer activations kept in workspace.
+    const std::vector<double> &forward(const double *input, Workspace &workspace) const;
+    /// Runs network on input with given indices set to 1.0 and all others 0.0.
+    /// Returns output layer activations kept in workspace.
+    const std::vector<double> &forwardOneHot(const unsigned *activeInputs, size_t activeCount, Workspace &workspace) const;
+    /// Adds gradient of 0.5 * sum((output - target)^2) over outputs with mask set
+    /// to gradient. forwardOneHot with the same input has to be called first.
+    void backwardOneHot(const unsigned *activeInputs, size_t activeCount, const double *targets,
+                        const bool *outputMask, Workspace &workspace, std::vector<double> &gradient) const;
+
+protected:
+    const std::vector<double> &forwardHiddenLayers(Workspace &workspace) const;
+    double activate(const Layer &layer, double sum) const;
+    double derivative(const Layer &layer, double output) const;
+
+private:
+    std::vector<Layer> _layers;
+    std::vector<double> _parameters;
+};
+
+}
+
+#endif // MULTILAYERPERCEPTRON_H
@@ -0,0 +1,168 @@
+#include "NTupleNetwork.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace nn2048
+{
+
+static const char FileMagic[8] = { 'N', 'T', 'U', 'P', 'L', 'E', '0', '1' };
+static const unsigned MaxTupleLength = 7;
+static const unsigned MaxTupleCount = 64;
+
+NTupleNetwork::NTupleNetwork():
+    NTupleNetwork({
+        { 0, 1, 2, 3, 4, 5 },
+        { 4, 5, 6, 7, 8, 9 },
+        { 0, 1, 2, 3 },
+        { 4, 5, 6, 7 },
+        { 0, 1, 4, 5 },
+        { 1, 2, 5, 6 },
+        { 5, 6, 9, 10 }
+    })
+{}
+
+NTupleNetwork::NTupleNetwork(const std::vector<Tuple> &tuples):
+    _tuples(tuples)
+{
+    if (_tuples.empty() || _tuples.size() > MaxTupleCount)
+        throw std::invalid_argument("Tuple count has to be between 1 and " + std::to_string(MaxTupleCount));
+    _tables.reserve(_tuples.size());
+    for (auto &tuple: _tuples) {
+        if (tuple.empty() || tuple.size() > MaxTupleLength)
+            throw std::invalid_argument("Tuple length has to be between 1 and " + std::to_string(MaxTupleLength));
+        for (auto position: tuple)
+            if (position >= BoardPacker::numberOfTiles)
+                throw std::invalid_argument("Tuple position out of board");
+        _tables.emplace_back(size_t(1) << (4 * tuple.size()), 0.0f);
+    }
+    initializeSymmetricTuples();
+}
+
+std::unique_ptr<NTupleNetwork> NTupleNetwork::load(const std::string &fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Cannot open n-tuple network file " + fileName);
+
+    char magic[sizeof(FileMagic)];
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, FileMagic, sizeof(FileMagic)) != 0)
+        throw std::runtime_error(fileName + " is not an n-tuple network file");
+
+    std::uint32_t tupleCount = 0;
+    file.read(reinterpret_cast<char *>(&tupleCount), sizeof(tupleCount));
+    if (!file || tupleCount == 0 || tupleCount > MaxTupleCount)
+        throw std::runtime_error("Invalid tuple count in " + fileName);
+    std::vector<Tuple> tuples(tupleCount);
+    for (auto &tuple: tuples) {
+        std::uint32_t length = 0;
+        file.read(reinterpret_cast<char *>(&length), sizeof(length));
+        if (!file || length == 0 || length > MaxTupleLength)
+            throw std::runtime_error("Invalid tuple length in " + fileName);
+        for (std::uint32_t i = 0; i < length; ++i) {
+            std::uint32_t position = 0;
+            file.read(reinterpret_cast<char *>(&position), sizeof(position));
+            if (!file || position >= BoardPacker::numberOfTiles)
+                throw std::runtime_error("Invalid tuple position in " + fileName);
+            tuple.push_back(position);
+        }
+    }
+    if (!file)
+        throw std::runtime_error("Unexpected end of file " + fileName);
+
+    auto network = std::make_unique<NTupleNetwork>(tuples);
+    for (auto &table: network->_tables) {
+        file.read(reinterpret_cast<char *>(&table[0]), static_cast<std::streamsize>(table.size() * sizeof(float)));
+        if (!file)
+            throw std::runtime_error("Unexpected end of file " + fileName);
+    }
+    return network;
+}
+
+bool NTupleNetwork::isNTupleNetworkFile(const std::string &fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    char magic[sizeof(FileMagic)];
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, FileMagic, sizeof(FileMagic)) == 0;
+}
+
+bool NTupleNetwork::save(const std::string &fileName) const
+{
+    std::ofstream file(fileName, std::ios::binary);
+    if (!file)
+        return false;
+
+    file.write(FileMagic, sizeof(FileMagic));
+    auto tupleCount = static_cast<std::uint32_t>(_tuples.size());
+    file.write(reinterpret_cast<const char *>(&tupleCount), sizeof(tupleCount));
+    for (auto &tuple: _tuples) {
+        auto length = static_cast<std::uint32_t>(tuple.size());
+        file.write(reinterpret_cast<const char *>(&length), sizeof(length));
+        for (auto position: tuple) {
+            auto storedPosition = static_cast<std::uint32_t>(position);
+            file.write(reinterpret_cast<const char *>(&storedPosition), sizeof(storedPosition));
+        }
+    }
+    for (auto &table: _tables)
+        file.write(reinterpret_cast<const char *>(&table[0]), static_cast<std::streamsize>(table.size() * sizeof(float)));
+    return static_cast<bool>(file);
+}
+
+void NTupleNetwork::evaluate(const std::vector<PackedBoard> &boards, std::vector<double> &values) const
+{
+    values.clear();
+    values.reserve(boards.size());
+    for (auto board: boards)
+        values.push_back(value(board));
+}
+
+double NTupleNetwork::value(PackedBoard board) const
+{
+    double sum = 0.0;
+    for (auto &tuple: _symmetricTuples)
+        sum += _tables[tuple.second][tableIndex(board, tuple.first)];
+    return sum;
+}
+
+double NTupleNetwork::update(PackedBoard board, double target, double learningRate)
+{
+    double error = target - value(board);
+    auto delta = static_cast<float>(learningRate * error / _symmetricTuples.size());
+    for (auto &tuple: _symmetricTuples)
+        _tables[tuple.second][tableIndex(board, tuple.first)] += delta;
+    return error;
+}
+
+void NTupleNetwork::initializeSymmetricTuples()
+{
+    _symmetricTuples.clear();
+    for (size_t i = 0; i < _tuples.size(); ++i) {
+        for (unsigned symmetry = 0; symmetry < 8; ++symmetry) {
+            Tuple positions;
+            for (auto position: _tuples[i]) {
+                unsigned row = position / 4;
+                unsigned column = position % 4;
+                if (symmetry >= 4)
+                    column = 3 - column;
+                for (unsigned rotation = 0; rotation < symmetry % 4; ++rotation) {
+                    unsigned rotatedRow = column;
+                    column = 3 - row;
+                    row = rotatedRow;
+                }
+                positions.push_back(row * 4 + column);
+            }
+            _symmetricTuples.push_back({ positions, i });
+        }
+    }
+}
+
+unsigned NTupleNetwork::tableIndex(PackedBoard board, const Tuple &positions)
+{
+    unsigned index = 0;
+    for (size_t i = 0; i < positions.size(); ++i)
+        index |= BoardPacker::exponent(board, positions[i]) << (4 * i);
+    return index;
+}
+
+}
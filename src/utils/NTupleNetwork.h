@@ -0,0 +1,55 @@
+#ifndef NTUPLENETWORK_H
+#define NTUPLENETWORK_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BoardEvaluator.h"
+
+namespace nn2048
+{
+
+/// Value function made of lookup tables indexed by tile exponents found at
+/// chosen board positions (tuples). Every tuple is sampled in all 8 board
+/// symmetries and board value is the sum of all looked up weights.
+/// Boards are evaluated as afterstates, so merge reward is added on top.
+class NTupleNetwork: public BoardEvaluator
+{
+public:
+    typedef std::vector<unsigned> Tuple;
+
+    /// Creates network with default 4- and 6-tuples and zero weights
+    NTupleNetwork();
+    NTupleNetwork(const std::vector<Tuple> &tuples);
+
+    /// Loads network saved with save(), throws std::runtime_error on failure
+    static std::unique_ptr<NTupleNetwork> load(const std::string &fileName);
+    static bool isNTupleNetworkFile(const std::string &fileName);
+    bool save(const std::string &fileName) const;
+
+    void evaluate(const std::vector<PackedBoard> &boards, std::vector<double> &values) const;
+    double rewardWeight() const { return 1.0; }
+
+    double value(PackedBoard board) const;
+    /// Moves value of the board towards target by learningRate fraction of the error.
+    /// Returns error before the update.
+    double update(PackedBoard board, double target, double learningRate);
+
+    const std::vector<Tuple> &tuples() const { return _tuples; }
+    unsigned featureCount() const { return static_cast<unsigned>(_symmetricTuples.size()); }
+
+protected:
+    void initializeSymmetricTuples();
+    static unsigned tableIndex(PackedBoard board, const Tuple &positions);
+
+private:
+    std::vector<Tuple> _tuples;
+    std::vector<std::vector<float>> _tables;
+    /// Every tuple in every symmetry paired with index of its table
+    std::vector<std::pair<Tuple, size_t>> _symmetricTuples;
+};
+
+}
+
+#endif // NTUPLENETWORK_H
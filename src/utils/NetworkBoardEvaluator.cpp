@@ -0,0 +1,37 @@
+#include "NetworkBoardEvaluator.h"
+#include <algorithm>
+#include "BoardSignalConverter.h"
+
+namespace nn2048
+{
+
+NetworkBoardEvaluator::NetworkBoardEvaluator(const NeuralNetwork::Network *network):
+    _network(network)
+{}
+
+NetworkBoardEvaluator::NetworkBoardEvaluator(std::unique_ptr<NeuralNetwork::Network> network):
+    _ownedNetwork(std::move(network)),
+    _network(_ownedNetwork.get())
+{}
+
+void NetworkBoardEvaluator::evaluate(const std::vector<PackedBoard> &boards, std::vector<double> &values) const
+{
+    values.clear();
+    values.reserve(boards.size());
+    for (auto board: boards) {
+        auto response = _network->responses(BoardSignalConverter::packedBoardToSignal(board));
+        values.push_back(*std::max_element(response.begin(), response.end()));
+    }
+}
+
+void NetworkBoardEvaluator::evaluateMoves(const std::vector<PackedBoard> &boards, std::vector<double> &values) const
+{
+    values.clear();
+    values.reserve(boards.size() * static_cast<unsigned>(Game2048Core::Direction::Total));
+    for (auto board: boards) {
+        auto response = _network->responses(BoardSignalConverter::packedBoardToSignal(board));
+        values.insert(values.end(), response.begin(), response.end());
+    }
+}
+
+}
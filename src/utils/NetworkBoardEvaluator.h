@@ -0,0 +1,30 @@
+#ifndef NETWORKBOARDEVALUATOR_H
+#define NETWORKBOARDEVALUATOR_H
+
+#include <memory>
+#include <Network.h>
+#include "BoardEvaluator.h"
+
+namespace nn2048
+{
+
+/// Evaluates boards with json neural network fed by BoardSignalConverter::boardToSignal.
+/// Network outputs are move values, board value is the greatest of them.
+class NetworkBoardEvaluator: public BoardEvaluator
+{
+public:
+    NetworkBoardEvaluator(const NeuralNetwork::Network *network);
+    /// Evaluator owning the network
+    NetworkBoardEvaluator(std::unique_ptr<NeuralNetwork::Network> network);
+
+    void evaluate(const std::vector<PackedBoard> &boards, std::vector<double> &values) const;
+    void evaluateMoves(const std::vector<PackedBoard> &boards, std::vector<double> &values) const;
+
+private:
+    std::unique_ptr<NeuralNetwork::Network> _ownedNetwork;
+    const NeuralNetwork::Network *_network;
+};
+
+}
+
+#endif // NETWORKBOARDEVALUATOR_H
@@ -0,0 +1,81 @@
+#include "PerceptronBoardEvaluator.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include "BoardSignalConverter.h"
+
+namespace nn2048
+{
+
+namespace
+{
+
+const std::string FannFileHeader = "FANN_";
+
+}
+
+PerceptronBoardEvaluator::PerceptronBoardEvaluator(MultilayerPerceptron perceptron):
+    _perceptron(std::move(perceptron)),
+    _bitSignal(_perceptron.inputCount() == BoardSignalConverter::numberOfSignalBits)
+{
+    if (!isSupportedInputCount(_perceptron.inputCount()))
+        throw std::invalid_argument("Network input count " + std::to_string(_perceptron.inputCount()) + " matches no board encoding");
+}
+
+bool PerceptronBoardEvaluator::isFannNetworkFile(const std::string &fileName)
+{
+    std::ifstream file(fileName);
+    std::string header(FannFileHeader.size(), '\0');
+    return file.read(&header[0], static_cast<std::streamsize>(header.size())) && header == FannFileHeader;
+}
+
+bool PerceptronBoardEvaluator::isSupportedInputCount(unsigned inputCount)
+{
+    return inputCount == BoardSignalConverter::numberOfSignalBits || inputCount == BoardSignalConverter::numberOfTiles;
+}
+
+void PerceptronBoardEvaluator::evaluate(const std::vector<PackedBoard> &boards, std::vector<double> &values) const
+{
+    auto workspace = _perceptron.createWorkspace();
+    values.clear();
+    values.reserve(boards.size());
+    for (auto board: boards) {
+        auto &outputs = run(board, workspace);
+        values.push_back(*std::max_element(outputs.begin(), outputs.end()));
+    }
+}
+
+void PerceptronBoardEvaluator::evaluateMoves(const std::vector<PackedBoard> &boards, std::vector<double> &values) const
+{
+    if (_perceptron.outputCount() != static_cast<unsigned>(Game2048Core::Direction::Total)) {
+        BoardEvaluator::evaluateMoves(boards, values);
+        return;
+    }
+
+    auto workspace = _perceptron.createWorkspace();
+    values.clear();
+    values.reserve(boards.size() * _perceptron.outputCount());
+    for (auto board: boards) {
+        auto &outputs = run(board, workspace);
+        values.insert(values.end(), outputs.begin(), outputs.end());
+    }
+}
+
+const std::vector<double> &PerceptronBoardEvaluator::run(PackedBoard board, MultilayerPerceptron::Workspace &workspace) const
+{
+    if (!_bitSignal) {
+        auto signal = BoardSignalConverter::packedBoardToSignal(board);
+        return _perceptron.forward(&signal[0], workspace);
+    }
+
+    unsigned activeInputs[BoardPacker::numberOfTiles];
+    size_t activeCount = 0;
+    for (unsigned tile = 0; tile < BoardPacker::numberOfTiles; ++tile) {
+        auto exponent = BoardPacker::exponent(board, tile);
+        if (exponent > 0)
+            activeInputs[activeCount++] = tile * BoardSignalConverter::numberOfPossibleValues + exponent - 1;
+    }
+    return _perceptron.forwardOneHot(activeInputs, activeCount, workspace);
+}
+
+}
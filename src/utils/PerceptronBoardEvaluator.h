@@ -0,0 +1,38 @@
+#ifndef PERCEPTRONBOARDEVALUATOR_H
+#define PERCEPTRONBOARDEVALUATOR_H
+
+#include <string>
+#include "BoardEvaluator.h"
+#include "MultilayerPerceptron.h"
+
+namespace nn2048
+{
+
+/// Evaluates boards with perceptron copied from FANN network. Network state
+/// is kept in per call workspaces, so calls from many threads run in parallel.
+/// Input encoding is picked by the network input count (16 - boardToSignal,
+/// 256 - boardToBitSignal), bit signal is fed to the first layer as indices
+/// of its active inputs. Network outputs are move values.
+class PerceptronBoardEvaluator: public BoardEvaluator
+{
+public:
+    /// Throws std::invalid_argument when input count matches no board encoding
+    PerceptronBoardEvaluator(MultilayerPerceptron perceptron);
+
+    static bool isFannNetworkFile(const std::string &fileName);
+    static bool isSupportedInputCount(unsigned inputCount);
+
+    void evaluate(const std::vector<PackedBoard> &boards, std::vector<double> &values) const;
+    void evaluateMoves(const std::vector<PackedBoard> &boards, std::vector<double> &values) const;
+
+protected:
+    const std::vector<double> &run(PackedBoard board, MultilayerPerceptron::Workspace &workspace) const;
+
+private:
+    MultilayerPerceptron _perceptron;
+    bool _bitSignal;
+};
+
+}
+
+#endif // PERCEPTRONBOARDEVALUATOR_H
@@ -8,6 +8,7 @@ static const std::string TakenActionKey = "takenAction";
 static const std::string ReinforcementKey = "reinforcement";
 static const std::string MoveFailedKey = "moveFailed";
 static const std::string TerminalStateKey = "terminalState";
+static const std::string EpisodeEndKey = "episodeEnd";
 
 std::string directionToString(Game2048Core::Direction direction)
 {
@@ -55,6 +56,7 @@ QLearningState::QLearningState(const Json::Value &json)
     deserializeReinforcement(json);
     deserializeMoveFailedValue(json);
     deserializeTerminalStateValue(json);
+    deserializeEpisodeEndValue(json);
 }
 
 QLearningState::QLearningState(QLearningState &&other)
@@ -63,10 +65,15 @@ QLearningState::QLearningState(QLearningState &&other)
     _action = other._action;
     _reward = other._reward;
     _terminalState = other._terminalState;
+    _episodeEnd = other._episodeEnd;
+    _return = other._return;
+    _successor = std::move(other._successor);
 
     other._action = Game2048Core::Direction::None;
     other._reward = 0.0;
     other._terminalState = false;
+    other._episodeEnd = false;
+    other._return = 0.0;
 }
 
 QLearningState &QLearningState::operator =(QLearningState &&other)
@@ -75,11 +82,16 @@ QLearningState &QLearningState::operator =(QLearningState &&other)
     _action = other._action;
     _reward = other._reward;
     _terminalState = other._terminalState;
+    _episodeEnd = other._episodeEnd;
+    _return = other._return;
+    _successor = std::move(other._successor);
 
     other._boardSignal.clear();
     other._action = Game2048Core::Direction::None;
     other._reward = 0.0;
     other._terminalState = false;
+    other._episodeEnd = false;
+    other._return = 0.0;
 
     return *this;
 }
@@ -154,6 +166,20 @@ void QLearningState::deserializeTerminalStateValue(const Json::Value &json)
     }
 }
 
+void QLearningState::deserializeEpisodeEndValue(const Json::Value &json)
+{
+    // Optional, older replay files mark games with terminal states only
+    if (json.isMember(EpisodeEndKey)) {
+        auto episodeEndJson = json[EpisodeEndKey];
+        if (episodeEndJson.type() != Json::booleanValue) {
+            throw std::runtime_error("episodeEnd field is not a boolean value");
+        }
+        _episodeEnd = episodeEndJson.asBool();
+    } else {
+        _episodeEnd = false;
+    }
+}
+
 Json::Value QLearningState::toJsonValue() const
 {
     auto json = Json::Value(Json::objectValue);
@@ -167,6 +193,8 @@ Json::Value QLearningState::toJsonValue() const
     json[ReinforcementKey] = _reward;
     json[MoveFailedKey] = _moveFailed;
     json[TerminalStateKey] = _terminalState;
+    if (_episodeEnd)
+        json[EpisodeEndKey] = true;
 
     return json;
 }
@@ -1,6 +1,7 @@
 #ifndef QLEARNINGSTATE_H
 #define QLEARNINGSTATE_H
 
+#include <memory>
 #include <vector>
 #include <GameCore.h>
 #include <json/json.h>
@@ -27,6 +28,18 @@ public:
     bool hasMoveFailed() const { return _moveFailed; }
     bool isInTerminalState() const { return _terminalState; }
     void setTerminalState(bool terminalState) { _terminalState = terminalState; }
+    /// Last state of a recorded game, returns are not carried over it
+    bool isEpisodeEnd() const { return _episodeEnd; }
+    void setEpisodeEnd(bool episodeEnd) { _episodeEnd = episodeEnd; }
+
+    /// Discounted sum of rewards until the end of episode, see ReplayMemory::computeReturns
+    double discountedReturn() const { return _return; }
+    void setDiscountedReturn(double discountedReturn) { _return = discountedReturn; }
+
+    /// Copy of the following state owned by states sampled out of their episode
+    /// (see ReplayReservoir). Replay batches use it as the next state.
+    const QLearningState *successor() const { return _successor.get(); }
+    void setSuccessor(std::unique_ptr<QLearningState> successor) { _successor = std::move(successor); }
 
     void setNextState(const QLearningState * next) { _nextState = next; }
     const QLearningState *nextState() const { return _nextState; }
@@ -42,6 +55,7 @@ protected:
     void deserializeReinforcement(const Json::Value &json);
     void deserializeMoveFailedValue(const Json::Value &json);
     void deserializeTerminalStateValue(const Json::Value &json);
+    void deserializeEpisodeEndValue(const Json::Value &json);
 
 private:
     std::vector<double> _boardSignal;
@@ -49,6 +63,9 @@ private:
     double _reward;
     bool _moveFailed;
     bool _terminalState;
+    bool _episodeEnd = false;
+    double _return = 0.0;
+    std::unique_ptr<QLearningState> _successor;
     const QLearningState *_nextState = nullptr;
 };
 
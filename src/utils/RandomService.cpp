@@ -0,0 +1,89 @@
+#include "RandomService.h"
+#include <chrono>
+#include <random>
+#include "Fnv1a.h"
+
+namespace nn2048
+{
+
+namespace
+{
+
+std::uint64_t splitMix64(std::uint64_t &state)
+{
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+std::uint64_t rotateLeft(std::uint64_t value, int shift)
+{
+    return (value << shift) | (value >> (64 - shift));
+}
+
+}
+
+RandomStream::RandomStream(std::uint64_t seed)
+{
+    for (auto &word: _state)
+        word = splitMix64(seed);
+}
+
+RandomStream::result_type RandomStream::operator()()
+{
+    const std::uint64_t result = rotateLeft(_state[1] * 5, 7) * 9;
+    const std::uint64_t t = _state[1] << 17;
+    _state[2] ^= _state[0];
+    _state[3] ^= _state[1];
+    _state[1] ^= _state[2];
+    _state[0] ^= _state[3];
+    _state[2] ^= t;
+    _state[3] = rotateLeft(_state[3], 45);
+    return result;
+}
+
+double RandomStream::nextDouble()
+{
+    return static_cast<double>((*this)() >> 11) / 9007199254740992.0;
+}
+
+std::uint64_t RandomStream::nextIndex(std::uint64_t bound)
+{
+    // Rejection removes modulo bias
+    const std::uint64_t threshold = (0 - bound) % bound;
+    std::uint64_t value;
+    do {
+        value = (*this)();
+    } while (value < threshold);
+    return value % bound;
+}
+
+std::uint64_t RandomService::_seed = 0;
+
+void RandomService::setSeed(std::uint64_t seed)
+{
+    _seed = seed;
+}
+
+std::uint64_t RandomService::seed()
+{
+    return _seed;
+}
+
+RandomStream RandomService::stream(const std::string &name, std::uint64_t index)
+{
+    std::uint64_t state = _seed ^ Fnv1a::hash(name);
+    std::uint64_t streamSeed = splitMix64(state);
+    state = streamSeed ^ index;
+    return RandomStream(splitMix64(state) ^ index * 0xd1b54a32d192ed03ULL);
+}
+
+std::uint64_t RandomService::randomSeed()
+{
+    std::random_device randomDevice;
+    auto time = static_cast<std::uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    return (static_cast<std::uint64_t>(randomDevice()) << 32 | randomDevice()) ^ time;
+}
+
+}
@@ -0,0 +1,56 @@
+#ifndef RANDOMSERVICE_H
+#define RANDOMSERVICE_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace nn2048
+{
+
+/// Fast xoshiro256** generator. Every component owns its stream, so streams
+/// do not share state and can be used from different threads. Meets
+/// UniformRandomBitGenerator requirements, works with std distributions.
+class RandomStream
+{
+public:
+    typedef std::uint64_t result_type;
+
+    explicit RandomStream(std::uint64_t seed = 0);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()();
+
+    /// Uniform value from [0, 1)
+    double nextDouble();
+    /// Uniform value from [0, bound), bound has to be greater than 0
+    std::uint64_t nextIndex(std::uint64_t bound);
+
+private:
+    std::uint64_t _state[4];
+};
+
+/// Source of named random streams derived from one seed. Same seed, stream
+/// name and index always produce the same sequence, so runs can be repeated
+/// no matter how many threads pull from their own streams.
+class RandomService
+{
+public:
+    static void setSeed(std::uint64_t seed);
+    static std::uint64_t seed();
+
+    /// Stream for component identified by name, index separates parallel actors
+    static RandomStream stream(const std::string &name, std::uint64_t index = 0);
+
+    /// Seed that changes between runs, used when user does not specify one
+    static std::uint64_t randomSeed();
+
+private:
+    static std::uint64_t _seed;
+};
+
+}
+
+#endif // RANDOMSERVICE_H
@@ -0,0 +1,43 @@
+#include "ReloadableBoardEvaluator.h"
+#include <stdexcept>
+
+namespace nn2048
+{
+
+ReloadableBoardEvaluator::ReloadableBoardEvaluator(std::shared_ptr<const BoardEvaluator> model):
+    _model(std::move(model)),
+    _version(0)
+{
+    if (!_model)
+        throw std::invalid_argument("Reloadable evaluator requires model");
+}
+
+void ReloadableBoardEvaluator::evaluate(const std::vector<PackedBoard> &boards, std::vector<double> &values) const
+{
+    snapshot()->evaluate(boards, values);
+}
+
+void ReloadableBoardEvaluator::evaluateMoves(const std::vector<PackedBoard> &boards, std::vector<double> &values) const
+{
+    snapshot()->evaluateMoves(boards, values);
+}
+
+double ReloadableBoardEvaluator::rewardWeight() const
+{
+    return snapshot()->rewardWeight();
+}
+
+std::shared_ptr<const BoardEvaluator> ReloadableBoardEvaluator::snapshot() const
+{
+    return std::atomic_load(&_model);
+}
+
+void ReloadableBoardEvaluator::replace(std::shared_ptr<const BoardEvaluator> model)
+{
+    if (!model)
+        throw std::invalid_argument("Reloadable evaluator requires model");
+    std::atomic_store(&_model, std::move(model));
+    ++_version;
+}
+
+}
@@ -0,0 +1,35 @@
+#ifndef RELOADABLEBOARDEVALUATOR_H
+#define RELOADABLEBOARDEVALUATOR_H
+
+#include <atomic>
+#include <memory>
+#include "BoardEvaluator.h"
+
+namespace nn2048
+{
+
+/// Delegates to a model which can be replaced while it is used. Every call
+/// takes a reference to the current model, so calls running during the swap
+/// finish on the old model and it is released with the last of them.
+class ReloadableBoardEvaluator: public BoardEvaluator
+{
+public:
+    ReloadableBoardEvaluator(std::shared_ptr<const BoardEvaluator> model);
+
+    void evaluate(const std::vector<PackedBoard> &boards, std::vector<double> &values) const;
+    void evaluateMoves(const std::vector<PackedBoard> &boards, std::vector<double> &values) const;
+    double rewardWeight() const;
+    std::shared_ptr<const BoardEvaluator> snapshot() const;
+
+    void replace(std::shared_ptr<const BoardEvaluator> model);
+    /// Number of replacements so far
+    unsigned version() const { return _version; }
+
+private:
+    std::shared_ptr<const BoardEvaluator> _model;
+    std::atomic<unsigned> _version;
+};
+
+}
+
+#endif // RELOADABLEBOARDEVALUATOR_H
@@ -0,0 +1,110 @@
+#include "ReplayDeduplicator.h"
+#include <algorithm>
+#include <limits>
+
+namespace nn2048
+{
+
+namespace
+{
+
+Game2048Core::Direction transposeDirection(Game2048Core::Direction direction)
+{
+    switch (direction) {
+    case Game2048Core::Direction::Up:
+        return Game2048Core::Direction::Left;
+    case Game2048Core::Direction::Left:
+        return Game2048Core::Direction::Up;
+    case Game2048Core::Direction::Down:
+        return Game2048Core::Direction::Right;
+    case Game2048Core::Direction::Right:
+        return Game2048Core::Direction::Down;
+    default:
+        return direction;
+    }
+}
+
+Game2048Core::Direction mirrorDirection(Game2048Core::Direction direction)
+{
+    switch (direction) {
+    case Game2048Core::Direction::Left:
+        return Game2048Core::Direction::Right;
+    case Game2048Core::Direction::Right:
+        return Game2048Core::Direction::Left;
+    default:
+        return direction;
+    }
+}
+
+}
+
+ReplayDeduplicator::ReplayDeduplicator(bool reduceSymmetries):
+    _reduceSymmetries(reduceSymmetries),
+    _inputCount(0)
+{ }
+
+void ReplayDeduplicator::add(const QLearningState &state)
+{
+    auto record = ReplayRecord::fromState(state);
+    auto action = state.takenAction();
+    if (_reduceSymmetries)
+        canonicalize(record.board, action);
+
+    Key key { record.board, static_cast<std::uint8_t>(action) };
+    auto inserted = _index.emplace(key, _samples.size());
+    if (inserted.second)
+        _samples.push_back({ key, record.flags, 0, 0.0 });
+
+    auto &sample = _samples[inserted.first->second];
+    ++sample.count;
+    sample.returnSum += state.discountedReturn();
+    ++_inputCount;
+}
+
+void ReplayDeduplicator::writeTo(ReplayWriter &writer) const
+{
+    for (auto &sample: _samples) {
+        ReplayRecord record;
+        record.board = sample.key.board;
+        record.action = sample.key.action;
+        record.reward = static_cast<float>(sample.returnSum / sample.count);
+        record.flags = static_cast<std::uint8_t>(sample.flags | EpisodeEndRecordFlag);
+        record.count = static_cast<std::uint16_t>(std::min<std::uint64_t>(sample.count, std::numeric_limits<std::uint16_t>::max()));
+        writer.writeRecord(record);
+    }
+}
+
+void ReplayDeduplicator::canonicalize(PackedBoard &board, Game2048Core::Direction &action)
+{
+    // Two mirrors and a transpose reach all 8 symmetries of the square
+    auto bestBoard = board;
+    auto bestAction = action;
+    auto currentBoard = board;
+    auto currentAction = action;
+    for (unsigned i = 0; i < 8; ++i) {
+        if (i % 2 == 0) {
+            currentBoard = BoardPacker::transpose(currentBoard);
+            currentAction = transposeDirection(currentAction);
+        } else {
+            currentBoard = BoardPacker::mirror(currentBoard);
+            currentAction = mirrorDirection(currentAction);
+        }
+        if (currentBoard < bestBoard) {
+            bestBoard = currentBoard;
+            bestAction = currentAction;
+        }
+    }
+    board = bestBoard;
+    action = bestAction;
+}
+
+size_t ReplayDeduplicator::KeyHash::operator ()(const Key &key) const
+{
+    // splitmix64 finalizer spreads similar boards over the whole table
+    std::uint64_t hash = key.board ^ (static_cast<std::uint64_t>(key.action) << 60) ^ key.action;
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+    return static_cast<size_t>(hash ^ (hash >> 31));
+}
+
+}
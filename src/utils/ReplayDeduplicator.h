@@ -0,0 +1,66 @@
+#ifndef REPLAYDEDUPLICATOR_H
+#define REPLAYDEDUPLICATOR_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "QLearningState.h"
+#include "ReplayShard.h"
+#include "ReplayWriter.h"
+
+namespace nn2048
+{
+
+/// Aggregates identical (board, action) samples of merged replays. Every
+/// unique sample keeps number of occurrences and mean discounted return,
+/// so states have to have their returns computed before they are added.
+/// Boards can be reduced by the 8 symmetries of the square, the action is
+/// transformed together with the board.
+class ReplayDeduplicator
+{
+public:
+    explicit ReplayDeduplicator(bool reduceSymmetries);
+
+    void add(const QLearningState &state);
+    /// Writes unique samples in order of first occurrence. Every sample is
+    /// a single state episode whose reward is the mean return.
+    void writeTo(ReplayWriter &writer) const;
+
+    std::uint64_t inputCount() const { return _inputCount; }
+    size_t uniqueCount() const { return _samples.size(); }
+
+    /// Canonical board and action, the smallest packed board of all symmetric variants
+    static void canonicalize(PackedBoard &board, Game2048Core::Direction &action);
+
+protected:
+    struct Key
+    {
+        PackedBoard board;
+        std::uint8_t action;
+
+        bool operator == (const Key &other) const { return board == other.board && action == other.action; }
+    };
+
+    struct KeyHash
+    {
+        size_t operator ()(const Key &key) const;
+    };
+
+    struct Sample
+    {
+        Key key;
+        std::uint8_t flags;
+        std::uint64_t count;
+        double returnSum;
+    };
+
+private:
+    bool _reduceSymmetries;
+    std::uint64_t _inputCount;
+    std::unordered_map<Key, size_t, KeyHash> _index;
+    std::vector<Sample> _samples;
+};
+
+}
+
+#endif // REPLAYDEDUPLICATOR_H
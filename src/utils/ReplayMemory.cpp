@@ -1,30 +1,31 @@
 #include "ReplayMemory.h"
 #include <stdexcept>
 #include <set>
-#include <random>
-#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <algorithm>
+#include <atomic>
 
 namespace nn2048
 {
 
 static const std::string SizeKey = "memorySize";
 static const std::string StatesKey = "states";
+/// Every memory samples from its own stream, numbered in construction order
+static std::atomic<std::uint64_t> nextSamplerIndex(0);
 
 ReplayMemory::ReplayMemory():
-    _size(0)
-{
-    initializeRandom();
-}
+    _size(0),
+    _sampler(RandomService::stream("replay-sampler", nextSamplerIndex++))
+{}
 
 ReplayMemory::ReplayMemory(unsigned size):
-    _size(size)
-{
-    initializeRandom();
-}
+    _size(size),
+    _sampler(RandomService::stream("replay-sampler", nextSamplerIndex++))
+{}
 
-ReplayMemory::ReplayMemory(const std::string &fileName)
+ReplayMemory::ReplayMemory(const std::string &fileName):
+    _sampler(RandomService::stream("replay-sampler", nextSamplerIndex++))
 {
     ReplayMemory(0);
     std::ifstream file(fileName);
@@ -62,18 +63,12 @@ ReplayMemory::ReplayMemory(const std::string &fileName)
             addState(std::move(state));
         }
         _memory.back()->setTerminalState(true);
+        _memory.back()->setEpisodeEnd(true);
     } else {
         throw std::runtime_error("Missing replay memory states array");
     }
 }
 
-void ReplayMemory::initializeRandom()
-{
-    std::random_device randomDevice;
-    std::uniform_int_distribution<unsigned> distribution(0, static_cast<unsigned>(time(nullptr)));
-    srand(distribution(randomDevice));
-}
-
 bool ReplayMemory::serialize(const std::string &fileName) const
 {
     auto json = Json::Value(Json::objectValue);
@@ -139,12 +134,14 @@ std::vector<const QLearningState *> ReplayMemory::sampleBatch(unsigned size)
 
     while (batch.size() < size)
     {
-        unsigned index = static_cast<unsigned>(rand()) % _memory.size();
+        auto index = static_cast<unsigned>(_sampler.nextIndex(_memory.size()));
         if (takenIndices.count(index) == 1) continue;
         takenIndices.insert(index);
 
         auto state = _memory[index].get();
-        if (state->isInTerminalState() == false && index < _memory.size() - 1)
+        if (state->successor())
+            state->setNextState(state->successor());
+        else if (state->isInTerminalState() == false && index < _memory.size() - 1)
             state->setNextState(_memory[index + 1].get());
         else if (state->hasMoveFailed())
             state->setNextState(state);
@@ -169,4 +166,49 @@ void ReplayMemory::takeStatesFrom(ReplayMemory &other)
     other._memory.clear();
 }
 
+std::deque<std::unique_ptr<QLearningState>> ReplayMemory::releaseStates()
+{
+    std::deque<std::unique_ptr<QLearningState>> states;
+    states.swap(_memory);
+    return states;
+}
+
+void ReplayMemory::computeReturns(double gamma, ThreadPool *threadPool)
+{
+    // Episode is [begin, end) range ending with terminal or episode end state, or memory end
+    std::vector<std::pair<size_t, size_t>> episodes;
+    size_t episodeBegin = 0;
+    for (size_t i = 0; i < _memory.size(); ++i) {
+        if (_memory[i]->isInTerminalState() || _memory[i]->isEpisodeEnd() || i + 1 == _memory.size()) {
+            episodes.push_back({ episodeBegin, i + 1 });
+            episodeBegin = i + 1;
+        }
+    }
+
+    auto computeEpisodes = [this, gamma, &episodes] (size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            double discountedReturn = 0.0;
+            for (size_t j = episodes[i].second; j > episodes[i].first; --j) {
+                auto &state = _memory[j - 1];
+                discountedReturn = state->receivedReward() + gamma * discountedReturn;
+                state->setDiscountedReturn(discountedReturn);
+            }
+        }
+    };
+
+    if (!threadPool || threadPool->threadCount() < 2 || episodes.size() < 2) {
+        computeEpisodes(0, episodes.size());
+        return;
+    }
+
+    size_t rangeSize = (episodes.size() + threadPool->threadCount() - 1) / threadPool->threadCount();
+    std::vector<std::future<void>> tasks;
+    for (size_t first = 0; first < episodes.size(); first += rangeSize) {
+        auto last = std::min(first + rangeSize, episodes.size());
+        tasks.push_back(threadPool->submit([&computeEpisodes, first, last] () { computeEpisodes(first, last); }));
+    }
+    for (auto &task: tasks)
+        task.get();
+}
+
 }
@@ -4,6 +4,8 @@
 #include <deque>
 #include <memory>
 #include "QLearningState.h"
+#include "RandomService.h"
+#include "ThreadPool.h"
 
 namespace nn2048
 {
@@ -36,15 +38,19 @@ public:
     unsigned long currentSize() const { return _memory.size(); }
 
     void takeStatesFrom(ReplayMemory &other);
+    /// Moves all states out, memory is left empty
+    std::deque<std::unique_ptr<QLearningState>> releaseStates();
 
-    const std::deque<std::unique_ptr<QLearningState>> &states() const { return _memory; }
+    /// Stores discounted return in every state. Episodes end at terminal states
+    /// and are walked backwards once; with thread pool they are split between workers.
+    void computeReturns(double gamma, ThreadPool *threadPool = nullptr);
 
-private:
-    void initializeRandom();
+    const std::deque<std::unique_ptr<QLearningState>> &states() const { return _memory; }
 
 private:
     unsigned _size;
     std::deque<std::unique_ptr<QLearningState>> _memory;
+    RandomStream _sampler;
 };
 
 }
@@ -1,17 +1,25 @@
 #include "ReplayMemoryTracker.h"
+#include <cstring>
 #include "BoardSignalConverter.h"
 #include "Reinforcement.h"
 
 namespace nn2048 {
 
+namespace
+{
+
+const size_t initialMoveCapacity = 1024;
+
+}
+
 ReplayMemoryTracker::ReplayMemoryTracker(Game2048Core::GameCore *gameCore):
     _gameCore(gameCore)
 {
     reset();
 
     _gameCore->onTryingToMoveTiles.connect([this] (Game2048Core::Direction) {
-        _boardSignal = BoardSignalConverter::boardToBitSignal(_gameCore->board());
-        _prevScore = _gameCore->score();
+        _board = BoardPacker::pack(_gameCore->board());
+        _hasBoard = true;
     });
 
     _gameCore->onTilesMoved.connect([this] (Game2048Core::Direction direction, bool succeeded) {
@@ -42,25 +50,97 @@ void ReplayMemoryTracker::onGameOver()
     saveNewState(true, Game2048Core::Direction::None);
 }
 
-bool ReplayMemoryTracker::serializeReplayMemory(const std::string &fileName)
+bool ReplayMemoryTracker::serializeReplayMemory(const std::string &fileName) const
 {
-    if (_replayMemory->currentSize() == 0)
+    if (moveCount() == 0)
         return false;
-    return _replayMemory->serialize(fileName);
+    return replayMemory()->serialize(fileName);
+}
+
+template<typename Visitor>
+void ReplayMemoryTracker::forEachRecord(Visitor visitor) const
+{
+    // Scores are replayed from merge rewards, final states (Direction::None)
+    // are rated against the score before the last tried move like the moves
+    unsigned score = 0;
+    unsigned prevScore = score;
+    for (size_t offset = 0; offset < _moves.size(); offset += moveSize) {
+        ReplayRecord record;
+        std::memcpy(&record.board, &_moves[offset], sizeof(PackedBoard));
+        auto flags = _moves[offset + sizeof(PackedBoard)];
+        auto direction = static_cast<Game2048Core::Direction>(flags & DirectionMask);
+        bool succeeded = (flags & MoveFailedFlag) == 0;
+        bool gameOver = (flags & GameOverFlag) != 0;
+
+        if (direction != Game2048Core::Direction::None) {
+            prevScore = score;
+            unsigned reward = 0;
+            if (succeeded)
+                BoardPacker::move(record.board, direction, reward);
+            score += reward;
+        }
+
+        record.reward = static_cast<float>(Reinforcement::computeReinforcement(gameOver, succeeded, score, prevScore));
+        record.action = static_cast<std::uint8_t>(direction);
+        record.flags = 0;
+        if (gameOver)
+            record.flags |= TerminalRecordFlag;
+        if (!succeeded)
+            record.flags |= MoveFailedRecordFlag;
+        record.count = 0;
+        visitor(record);
+    }
+}
+
+std::vector<ReplayRecord> ReplayMemoryTracker::records() const
+{
+    std::vector<ReplayRecord> records;
+    records.reserve(moveCount());
+    forEachRecord([&records] (const ReplayRecord &record) {
+        records.push_back(record);
+    });
+    if (!records.empty())
+        records.back().flags |= EpisodeEndRecordFlag;
+    return records;
+}
+
+std::unique_ptr<ReplayMemory> ReplayMemoryTracker::replayMemory() const
+{
+    auto replayMemory = std::make_unique<ReplayMemory>();
+    forEachRecord([&replayMemory] (const ReplayRecord &record) {
+        replayMemory->addState(BoardSignalConverter::packedBoardToBitSignal(record.board),
+                               static_cast<Game2048Core::Direction>(record.action),
+                               record.reward,
+                               record.hasFlag(MoveFailedRecordFlag),
+                               record.hasFlag(TerminalRecordFlag));
+    });
+    return replayMemory;
 }
 
 void ReplayMemoryTracker::reset()
 {
-    _replayMemory = std::make_unique<ReplayMemory>();
-    _prevScore = 0;
-    _boardSignal.clear();
+    _moves.clear();
+    _moves.reserve(initialMoveCapacity * moveSize);
+    _board = 0;
+    _hasBoard = false;
 }
 
 void ReplayMemoryTracker::saveNewState(bool succeeded, Game2048Core::Direction direction)
 {
-    auto reinforcement = Reinforcement::computeReinforcement(_gameCore->isGameOver(), succeeded, _gameCore->score(), _prevScore);
-    _replayMemory->addState(_boardSignal, direction, reinforcement, !succeeded, _gameCore->isGameOver());
-}
+    // Nothing was tried since reset, so there is no board to record
+    if (!_hasBoard)
+        return;
 
+    auto flags = static_cast<std::uint8_t>(static_cast<unsigned>(direction) & DirectionMask);
+    if (!succeeded)
+        flags |= MoveFailedFlag;
+    if (_gameCore->isGameOver())
+        flags |= GameOverFlag;
+
+    auto offset = _moves.size();
+    _moves.resize(offset + moveSize);
+    std::memcpy(&_moves[offset], &_board, sizeof(PackedBoard));
+    _moves[offset + sizeof(PackedBoard)] = flags;
+}
 
 }
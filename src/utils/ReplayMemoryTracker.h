@@ -1,32 +1,55 @@
 #ifndef REPLAYMEMORYTRACKER_H
 #define REPLAYMEMORYTRACKER_H
 
+#include <cstdint>
 #include <GameCore.h>
+#include "BoardPacker.h"
 #include "ReplayMemory.h"
+#include "ReplayShard.h"
 
 namespace nn2048 {
 
-/// Keeps track of game flow. Current game states and moves are passed to
-/// replay memory and serialized when game is reset or over.
+/// Keeps track of game flow. Every move is stored compactly as the packed
+/// board it was tried on and one byte holding the action and its outcome,
+/// all appended to a single buffer. Rewards are recomputed from the boards,
+/// so replay states are built only for games which are recorded.
 class ReplayMemoryTracker
 {
 public:
     ReplayMemoryTracker(Game2048Core::GameCore *gameCore);
 
-    bool serializeReplayMemory(const std::string &fileName);
+    bool serializeReplayMemory(const std::string &fileName) const;
+    /// Tracked game as binary records, the last one ends the episode
+    std::vector<ReplayRecord> records() const;
+    /// Tracked game as replay states
+    std::unique_ptr<ReplayMemory> replayMemory() const;
     void reset();
 
+    size_t moveCount() const { return _moves.size() / moveSize; }
+
 protected:
+    enum MoveFlags: std::uint8_t
+    {
+        DirectionMask = 0x0F,
+        MoveFailedFlag = 0x10,
+        GameOverFlag = 0x20
+    };
+
     void onTilesMoved(Game2048Core::Direction direction, bool succeeded);
     void onGameReset();
     void onGameOver();
     void saveNewState(bool succeeded, Game2048Core::Direction direction);
+    /// Replays tracked moves and passes every one as a record with its reward
+    template<typename Visitor>
+    void forEachRecord(Visitor visitor) const;
 
 private:
+    static const size_t moveSize = sizeof(PackedBoard) + 1;
+
     Game2048Core::GameCore *_gameCore;
-    std::unique_ptr<ReplayMemory> _replayMemory;
-    std::vector<double> _boardSignal;
-    unsigned _prevScore;
+    std::vector<std::uint8_t> _moves;
+    PackedBoard _board;
+    bool _hasBoard;
 };
 
 }
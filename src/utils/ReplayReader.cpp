@@ -0,0 +1,232 @@
+#include "ReplayReader.h"
+#include <cctype>
+#include <stdexcept>
+#include <zlib.h>
+#include "BoardSignalConverter.h"
+#include "Logger.h"
+#include "ReplayRecorder.h"
+
+namespace nn2048
+{
+
+static const std::string StatesKey = "states";
+
+static std::unique_ptr<QLearningState> stateFromRecord(const ReplayRecord &record)
+{
+    auto state = std::make_unique<QLearningState>(BoardSignalConverter::packedBoardToBitSignal(record.board),
+                                                  static_cast<Game2048Core::Direction>(record.action),
+                                                  record.reward,
+                                                  record.hasFlag(MoveFailedRecordFlag),
+                                                  record.hasFlag(TerminalRecordFlag));
+    state->setEpisodeEnd(record.hasFlag(EpisodeEndRecordFlag));
+    return state;
+}
+
+std::unique_ptr<ReplayReader> ReplayReader::open(const std::string &fileName)
+{
+    if (ReplayShard::isReplayShardFile(fileName))
+        return std::make_unique<ShardReplayReader>(fileName);
+    else if (ReplayRecorder::isRecordingFile(fileName))
+        return std::make_unique<CompressedReplayReader>(fileName);
+    return std::make_unique<JsonReplayReader>(fileName);
+}
+
+JsonReplayReader::JsonReplayReader(const std::string &fileName):
+    _file(fileName, std::ios::binary),
+    _buffer(_file.rdbuf()),
+    _firstState(true),
+    _statesFinished(false)
+{
+    if (!_file)
+        throw std::runtime_error("Cannot open replay memory file " + fileName);
+    Json::CharReaderBuilder builder;
+    _stateReader.reset(builder.newCharReader());
+
+    enterStatesArray();
+    _nextState = readState();
+}
+
+bool JsonReplayReader::next(std::unique_ptr<QLearningState> &state)
+{
+    if (!_nextState)
+        return false;
+    // One state is read ahead, so the last one is known when it is returned
+    state = std::move(_nextState);
+    _nextState = readState();
+    if (!_nextState) {
+        state->setTerminalState(true);
+        state->setEpisodeEnd(true);
+    }
+    return true;
+}
+
+std::unique_ptr<QLearningState> JsonReplayReader::readState()
+{
+    if (_statesFinished)
+        return nullptr;
+
+    int c = skipWhitespace();
+    if (c == ']') {
+        _buffer->sbumpc();
+        _statesFinished = true;
+        return nullptr;
+    }
+    if (!_firstState)
+        expect(',');
+    _firstState = false;
+
+    std::string text;
+    captureValue(text);
+    Json::Value json;
+    std::string errors;
+    if (!_stateReader->parse(text.data(), text.data() + text.size(), &json, &errors))
+        throw std::runtime_error("Replay state is not valid json: " + errors);
+    return std::make_unique<QLearningState>(json);
+}
+
+void JsonReplayReader::enterStatesArray()
+{
+    expect('{');
+    while (true) {
+        if (skipWhitespace() == '}')
+            throw std::runtime_error("Missing replay memory states array");
+        auto key = readString();
+        expect(':');
+        if (key == StatesKey) {
+            expect('[');
+            return;
+        }
+        std::string ignored;
+        captureValue(ignored);
+        if (skipWhitespace() == ',')
+            _buffer->sbumpc();
+    }
+}
+
+int JsonReplayReader::skipWhitespace()
+{
+    int c = _buffer->sgetc();
+    while (c != EOF && std::isspace(c))
+        c = _buffer->snextc();
+    return c;
+}
+
+void JsonReplayReader::expect(char expected)
+{
+    if (skipWhitespace() != expected)
+        throw std::runtime_error(std::string("Malformed replay memory json, expected ") + expected);
+    _buffer->sbumpc();
+}
+
+std::string JsonReplayReader::readString()
+{
+    // Keys are plain identifiers, escapes are kept as they are
+    expect('"');
+    std::string result;
+    int c;
+    while ((c = _buffer->sbumpc()) != '"') {
+        if (c == EOF)
+            throw std::runtime_error("Unterminated string in replay memory json");
+        result.push_back(static_cast<char>(c));
+        if (c == '\\')
+            result.push_back(static_cast<char>(_buffer->sbumpc()));
+    }
+    return result;
+}
+
+void JsonReplayReader::captureValue(std::string &output)
+{
+    output.clear();
+    int c = skipWhitespace();
+    if (c != '{' && c != '[' && c != '"') {
+        // Number or literal, ends at separator of the enclosing container
+        while (c != EOF && c != ',' && c != '}' && c != ']' && !std::isspace(c)) {
+            output.push_back(static_cast<char>(c));
+            c = _buffer->snextc();
+        }
+        return;
+    }
+
+    int depth = 0;
+    bool inString = false;
+    do {
+        c = _buffer->sbumpc();
+        if (c == EOF)
+            throw std::runtime_error("Unexpected end of replay memory json");
+        output.push_back(static_cast<char>(c));
+        if (inString) {
+            if (c == '\\') {
+                c = _buffer->sbumpc();
+                if (c == EOF)
+                    throw std::runtime_error("Unexpected end of replay memory json");
+                output.push_back(static_cast<char>(c));
+            } else if (c == '"') {
+                inString = false;
+            }
+        } else if (c == '"') {
+            inString = true;
+        } else if (c == '{' || c == '[') {
+            ++depth;
+        } else if (c == '}' || c == ']') {
+            --depth;
+        }
+    } while (depth > 0 || inString);
+}
+
+ShardReplayReader::ShardReplayReader(const std::string &fileName):
+    _shard(fileName),
+    _nextRecord(0)
+{ }
+
+bool ShardReplayReader::next(std::unique_ptr<QLearningState> &state)
+{
+    if (_nextRecord >= _shard.size())
+        return false;
+    state = stateFromRecord(_shard[_nextRecord++]);
+    return true;
+}
+
+CompressedReplayReader::CompressedReplayReader(const std::string &fileName):
+    _fileName(fileName),
+    _file(fileName, std::ios::binary),
+    _nextRecord(0)
+{
+    CompressedReplayHeader header;
+    if (!_file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        throw std::runtime_error("Replay recording could not be read (" + fileName + ")");
+    if (header.version != CompressedReplayHeader::Version || header.recordSize != sizeof(ReplayRecord))
+        throw std::runtime_error("Replay recording has unsupported format (" + fileName + ")");
+}
+
+bool CompressedReplayReader::next(std::unique_ptr<QLearningState> &state)
+{
+    while (_nextRecord >= _records.size()) {
+        if (!readChunk())
+            return false;
+    }
+    state = stateFromRecord(_records[_nextRecord++]);
+    return true;
+}
+
+bool CompressedReplayReader::readChunk()
+{
+    CompressedReplayChunkHeader header;
+    if (!_file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        return false;
+    _compressed.resize(header.compressedSize);
+    _records.resize(header.recordCount);
+    _nextRecord = 0;
+    if (!_file.read(reinterpret_cast<char *>(_compressed.data()), static_cast<std::streamsize>(_compressed.size()))) {
+        LOG_WARNING << "Truncated chunk at the end of " << _fileName << " omitted";
+        _records.clear();
+        return false;
+    }
+
+    auto rawSize = static_cast<uLongf>(_records.size() * sizeof(ReplayRecord));
+    if (uncompress(reinterpret_cast<Bytef *>(_records.data()), &rawSize, _compressed.data(), header.compressedSize) != Z_OK
+            || rawSize != _records.size() * sizeof(ReplayRecord))
+        throw std::runtime_error("Replay recording has corrupted chunk (" + _fileName + ")");
+    return true;
+}
+
+}
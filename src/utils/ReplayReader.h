@@ -0,0 +1,92 @@
+#ifndef REPLAYREADER_H
+#define REPLAYREADER_H
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <json/json.h>
+#include "QLearningState.h"
+#include "ReplayShard.h"
+
+namespace nn2048
+{
+
+/// Reads replay states one by one in a single pass, without loading the
+/// whole file. Counterpart of ReplayWriter.
+class ReplayReader
+{
+public:
+    virtual ~ReplayReader() = default;
+
+    /// Binary shard or recorder file reader for these files, json reader otherwise.
+    /// Throws std::runtime_error when file cannot be opened.
+    static std::unique_ptr<ReplayReader> open(const std::string &fileName);
+
+    /// Returns false at the end of file. Throws std::runtime_error on malformed input.
+    virtual bool next(std::unique_ptr<QLearningState> &state) = 0;
+};
+
+/// Streams states array of a replay memory json. Like ReplayMemory(fileName),
+/// the last state of the file is marked terminal and ends the episode.
+class JsonReplayReader: public ReplayReader
+{
+public:
+    explicit JsonReplayReader(const std::string &fileName);
+
+    bool next(std::unique_ptr<QLearningState> &state);
+
+protected:
+    std::unique_ptr<QLearningState> readState();
+    /// Moves to the first element of the states array
+    void enterStatesArray();
+    int skipWhitespace();
+    void expect(char expected);
+    std::string readString();
+    /// Copies one json value of any type to output
+    void captureValue(std::string &output);
+
+private:
+    std::ifstream _file;
+    std::streambuf *_buffer;
+    std::unique_ptr<Json::CharReader> _stateReader;
+    std::unique_ptr<QLearningState> _nextState;
+    bool _firstState;
+    bool _statesFinished;
+};
+
+/// Converts records of a mapped binary shard to states
+class ShardReplayReader: public ReplayReader
+{
+public:
+    explicit ShardReplayReader(const std::string &fileName);
+
+    bool next(std::unique_ptr<QLearningState> &state);
+
+private:
+    ReplayShard _shard;
+    size_t _nextRecord;
+};
+
+/// Reads compressed rolling files written by ReplayRecorder chunk by chunk.
+/// Truncated last chunk of a file still being written ends the file.
+class CompressedReplayReader: public ReplayReader
+{
+public:
+    explicit CompressedReplayReader(const std::string &fileName);
+
+    bool next(std::unique_ptr<QLearningState> &state);
+
+protected:
+    bool readChunk();
+
+private:
+    std::string _fileName;
+    std::ifstream _file;
+    std::vector<unsigned char> _compressed;
+    std::vector<ReplayRecord> _records;
+    size_t _nextRecord;
+};
+
+}
+
+#endif // REPLAYREADER_H
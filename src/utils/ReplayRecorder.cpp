@@ -0,0 +1,212 @@
+#include "ReplayRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <boost/filesystem.hpp>
+#include <zlib.h>
+#include "Logger.h"
+
+namespace nn2048
+{
+
+namespace
+{
+
+const std::chrono::milliseconds wakeInterval(100);
+const size_t maxGamesPerChunk = 256;
+const std::string PartialFileSuffix = ".part";
+
+}
+
+const char CompressedReplayHeader::Magic[8] = { 'N', 'N', 'R', 'E', 'P', 'L', 'Z', '1' };
+
+ReplayRecorder::ReplayRecorder(const std::string &directory, size_t queueCapacity, std::uint64_t maxFileSize):
+    _directory(directory),
+    _maxFileSize(maxFileSize),
+    _queue(queueCapacity),
+    _stopping(false),
+    _fileSize(0),
+    _submittedGames(0),
+    _droppedGames(0),
+    _writtenGames(0),
+    _writtenRecords(0),
+    _writtenChunks(0),
+    _rawBytes(0),
+    _compressedBytes(0),
+    _fileCount(0),
+    _maxQueueDepth(0)
+{
+    if (!boost::filesystem::is_directory(_directory))
+        throw std::runtime_error("Replay recording directory does not exist (" + _directory + ")");
+
+    char timestamp[32];
+    auto now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y%m%d-%H%M%S", std::gmtime(&now));
+    _filePrefix = std::string("replays-") + timestamp;
+
+    _writer = std::thread(&ReplayRecorder::writeLoop, this);
+}
+
+ReplayRecorder::~ReplayRecorder()
+{
+    _stopping = true;
+    _wakeCondition.notify_all();
+    _writer.join();
+}
+
+bool ReplayRecorder::isRecordingFile(const std::string &fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    CompressedReplayHeader header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        return false;
+    return std::memcmp(header.magic, CompressedReplayHeader::Magic, sizeof(header.magic)) == 0;
+}
+
+bool ReplayRecorder::submit(std::vector<ReplayRecord> game)
+{
+    ++_submittedGames;
+    if (game.empty())
+        return true;
+    if (!_queue.tryPush(std::move(game))) {
+        ++_droppedGames;
+        return false;
+    }
+
+    auto depth = _queue.size();
+    auto maxDepth = _maxQueueDepth.load();
+    while (depth > maxDepth && !_maxQueueDepth.compare_exchange_weak(maxDepth, depth));
+    // Writer also wakes up periodically, so a notification racing with its wait is not lost for long
+    _wakeCondition.notify_one();
+    return true;
+}
+
+ReplayRecorder::Statistics ReplayRecorder::statistics() const
+{
+    Statistics statistics;
+    statistics.submittedGames = _submittedGames;
+    statistics.droppedGames = _droppedGames;
+    statistics.writtenGames = _writtenGames;
+    statistics.writtenRecords = _writtenRecords;
+    statistics.writtenChunks = _writtenChunks;
+    statistics.rawBytes = _rawBytes;
+    statistics.compressedBytes = _compressedBytes;
+    statistics.fileCount = _fileCount;
+    statistics.queueDepth = _queue.size();
+    statistics.maxQueueDepth = _maxQueueDepth;
+    statistics.queueCapacity = _queue.capacity();
+    return statistics;
+}
+
+void ReplayRecorder::writeLoop()
+{
+    std::vector<ReplayRecord> chunk;
+    while (true) {
+        // Games queued before stopping are still written
+        bool stopping = _stopping;
+        auto gameCount = takeQueuedGames(chunk);
+        if (gameCount > 0) {
+            if (writeChunk(chunk))
+                _writtenGames += gameCount;
+            else
+                _droppedGames += gameCount;
+            continue;
+        }
+        if (stopping)
+            break;
+
+        std::unique_lock<std::mutex> lock(_wakeMutex);
+        _wakeCondition.wait_for(lock, wakeInterval, [this] () { return _stopping || _queue.size() > 0; });
+    }
+    finishFile();
+}
+
+size_t ReplayRecorder::takeQueuedGames(std::vector<ReplayRecord> &chunk)
+{
+    chunk.clear();
+    std::vector<ReplayRecord> game;
+    size_t gameCount = 0;
+    while (gameCount < maxGamesPerChunk && _queue.tryPop(game)) {
+        chunk.insert(chunk.end(), game.begin(), game.end());
+        ++gameCount;
+    }
+    return gameCount;
+}
+
+bool ReplayRecorder::writeChunk(const std::vector<ReplayRecord> &chunk)
+{
+    auto rawSize = static_cast<uLong>(chunk.size() * sizeof(ReplayRecord));
+    auto compressedSize = compressBound(rawSize);
+    _compressed.resize(compressedSize);
+    if (compress2(&_compressed[0], &compressedSize, reinterpret_cast<const Bytef *>(chunk.data()), rawSize, Z_DEFAULT_COMPRESSION) != Z_OK) {
+        LOG_WARNING << "ReplayRecorder: chunk of " << chunk.size() << " records could not be compressed";
+        return false;
+    }
+
+    CompressedReplayChunkHeader header;
+    header.recordCount = static_cast<std::uint32_t>(chunk.size());
+    header.compressedSize = static_cast<std::uint32_t>(compressedSize);
+    std::uint64_t chunkSize = sizeof(header) + compressedSize;
+    if (!_file.is_open() || _fileSize + chunkSize > _maxFileSize)
+        openNextFile();
+
+    _file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    _file.write(reinterpret_cast<const char *>(&_compressed[0]), static_cast<std::streamsize>(compressedSize));
+    // Whole chunks reach the disk, so files stay readable while being written
+    _file.flush();
+    if (!_file) {
+        LOG_WARNING << "ReplayRecorder: chunk of " << chunk.size() << " records could not be written";
+        // Games of earlier chunks are kept, next chunk goes to a new file
+        finishFile();
+        return false;
+    }
+    _fileSize += chunkSize;
+    ++_writtenChunks;
+    _writtenRecords += chunk.size();
+    _rawBytes += rawSize;
+    _compressedBytes += chunkSize;
+    return true;
+}
+
+void ReplayRecorder::openNextFile()
+{
+    finishFile();
+    _file.clear();
+
+    char index[16];
+    std::snprintf(index, sizeof(index), "-%05llu", static_cast<unsigned long long>(_fileCount.load()));
+    _fileName = (boost::filesystem::path(_directory) / (_filePrefix + index + ".nnrz")).string();
+    auto fileName = _fileName + PartialFileSuffix;
+    _file.open(fileName, std::ios::binary | std::ios::trunc);
+
+    CompressedReplayHeader header;
+    std::memcpy(header.magic, CompressedReplayHeader::Magic, sizeof(header.magic));
+    header.version = CompressedReplayHeader::Version;
+    header.recordSize = sizeof(ReplayRecord);
+    _file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    _fileSize = sizeof(header);
+    ++_fileCount;
+    if (!_file)
+        LOG_WARNING << "ReplayRecorder: could not create " << fileName;
+}
+
+void ReplayRecorder::finishFile()
+{
+    if (!_file.is_open())
+        return;
+    _file.close();
+    auto partialFileName = _fileName + PartialFileSuffix;
+    // Chunk interrupted by a write error is cut off, so the file stays readable
+    boost::system::error_code error;
+    boost::filesystem::resize_file(partialFileName, _fileSize, error);
+    if (error)
+        LOG_WARNING << "ReplayRecorder: could not truncate " << partialFileName << ": " << error.message();
+    // Merge picks up only finished files, the active one keeps growing
+    if (std::rename(partialFileName.c_str(), _fileName.c_str()) != 0)
+        LOG_WARNING << "ReplayRecorder: could not finish " << _fileName;
+}
+
+}
@@ -0,0 +1,120 @@
+#ifndef REPLAYRECORDER_H
+#define REPLAYRECORDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Defaults.h"
+#include "LockFreeQueue.h"
+#include "ReplayShard.h"
+
+namespace nn2048
+{
+
+/// Layout of recorder files: header followed by chunks, each made of chunk
+/// header and zlib compressed ReplayRecords of whole games.
+struct CompressedReplayHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+
+    static const char Magic[8];
+    static const std::uint32_t Version = 1;
+};
+
+struct CompressedReplayChunkHeader
+{
+    std::uint32_t recordCount;
+    std::uint32_t compressedSize;
+};
+
+static_assert(sizeof(CompressedReplayHeader) == 16, "Compressed replay header layout is part of the file format");
+static_assert(sizeof(CompressedReplayChunkHeader) == 8, "Compressed replay chunk layout is part of the file format");
+
+/// Records finished games on a background thread. Sessions hand games over
+/// through a lock-free queue and never wait for the disk: when the queue is
+/// full the game is dropped and counted. Writer thread takes all queued games
+/// at once, compresses them as one chunk and appends it to the current file.
+/// Files roll over after reaching the size limit. The active file carries
+/// .part suffix, which is removed once the file is complete.
+class ReplayRecorder
+{
+public:
+    struct Statistics
+    {
+        std::uint64_t submittedGames;
+        std::uint64_t droppedGames;
+        std::uint64_t writtenGames;
+        std::uint64_t writtenRecords;
+        std::uint64_t writtenChunks;
+        std::uint64_t rawBytes;
+        std::uint64_t compressedBytes;
+        std::uint64_t fileCount;
+        size_t queueDepth;
+        size_t maxQueueDepth;
+        size_t queueCapacity;
+    };
+
+    /// Throws std::runtime_error when directory does not exist
+    ReplayRecorder(const std::string &directory,
+                   size_t queueCapacity = DefaultRecorderQueueCapacity,
+                   std::uint64_t maxFileSize = DefaultRecorderFileSize);
+    /// Writes queued games before joining the writer
+    ~ReplayRecorder();
+
+    ReplayRecorder(const ReplayRecorder &) = delete;
+    ReplayRecorder &operator = (const ReplayRecorder &) = delete;
+
+    static bool isRecordingFile(const std::string &fileName);
+
+    /// Never blocks. Returns false when game was dropped because queue is full.
+    bool submit(std::vector<ReplayRecord> game);
+
+    Statistics statistics() const;
+
+protected:
+    void writeLoop();
+    /// Moves queued games to chunk, returns number of games taken
+    size_t takeQueuedGames(std::vector<ReplayRecord> &chunk);
+    bool writeChunk(const std::vector<ReplayRecord> &chunk);
+    void openNextFile();
+    /// Closes the active file, cuts it after the last whole chunk and removes
+    /// its .part suffix
+    void finishFile();
+
+private:
+    std::string _directory;
+    std::uint64_t _maxFileSize;
+    std::string _filePrefix;
+
+    LockFreeQueue<std::vector<ReplayRecord>> _queue;
+    std::mutex _wakeMutex;
+    std::condition_variable _wakeCondition;
+    std::atomic<bool> _stopping;
+    std::thread _writer;
+
+    std::ofstream _file;
+    std::string _fileName;
+    std::uint64_t _fileSize;
+    std::vector<unsigned char> _compressed;
+
+    std::atomic<std::uint64_t> _submittedGames;
+    std::atomic<std::uint64_t> _droppedGames;
+    std::atomic<std::uint64_t> _writtenGames;
+    std::atomic<std::uint64_t> _writtenRecords;
+    std::atomic<std::uint64_t> _writtenChunks;
+    std::atomic<std::uint64_t> _rawBytes;
+    std::atomic<std::uint64_t> _compressedBytes;
+    std::atomic<std::uint64_t> _fileCount;
+    std::atomic<size_t> _maxQueueDepth;
+};
+
+}
+
+#endif // REPLAYRECORDER_H
@@ -0,0 +1,70 @@
+#include "ReplayReservoir.h"
+#include <algorithm>
+
+namespace nn2048
+{
+
+namespace
+{
+
+const size_t noSlot = static_cast<size_t>(-1);
+
+}
+
+ReplayReservoir::ReplayReservoir(size_t capacity, const RandomStream &random, bool keepSuccessors):
+    _capacity(capacity),
+    _random(random),
+    _keepSuccessors(keepSuccessors),
+    _offeredCount(0),
+    _waitingSlot(noSlot)
+{ }
+
+void ReplayReservoir::offer(std::unique_ptr<QLearningState> state)
+{
+    // Successor is attached before the slot can be replaced by this state
+    if (_waitingSlot != noSlot)
+        _slots[_waitingSlot].state->setSuccessor(copyAsSuccessor(*state));
+    _waitingSlot = noSlot;
+
+    auto streamIndex = _offeredCount++;
+    size_t slot = noSlot;
+    if (_capacity == 0 || _slots.size() < _capacity) {
+        slot = _slots.size();
+        _slots.push_back({ streamIndex, nullptr });
+    } else {
+        auto candidate = _random.nextIndex(_offeredCount);
+        if (candidate < _capacity)
+            slot = static_cast<size_t>(candidate);
+    }
+    if (slot == noSlot)
+        return;
+
+    bool needsSuccessor = _keepSuccessors && !state->isInTerminalState() && !state->isEpisodeEnd() && !state->hasMoveFailed();
+    _slots[slot] = { streamIndex, std::move(state) };
+    if (needsSuccessor)
+        _waitingSlot = slot;
+}
+
+std::vector<std::unique_ptr<QLearningState>> ReplayReservoir::takeStates()
+{
+    std::sort(_slots.begin(), _slots.end(), [] (const Slot &first, const Slot &second) {
+        return first.streamIndex < second.streamIndex;
+    });
+
+    std::vector<std::unique_ptr<QLearningState>> states;
+    states.reserve(_slots.size());
+    for (auto &slot: _slots)
+        states.push_back(std::move(slot.state));
+    _slots.clear();
+    _waitingSlot = noSlot;
+    return states;
+}
+
+std::unique_ptr<QLearningState> ReplayReservoir::copyAsSuccessor(const QLearningState &state)
+{
+    // Only the board of the successor is read when bootstrapping
+    return std::make_unique<QLearningState>(state.boardSignal(), state.takenAction(), state.receivedReward(),
+                                            state.hasMoveFailed(), state.isInTerminalState());
+}
+
+}
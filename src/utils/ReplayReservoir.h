@@ -0,0 +1,54 @@
+#ifndef REPLAYRESERVOIR_H
+#define REPLAYRESERVOIR_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "QLearningState.h"
+#include "RandomService.h"
+
+namespace nn2048
+{
+
+/// Uniform sample of bounded size over a stream of replay states
+/// (reservoir sampling, algorithm R). After any number of offered states
+/// every one of them is kept with the same probability. Kept states which
+/// do not end their episode get a copy of the following state as
+/// successor, because their neighbours are usually not kept.
+class ReplayReservoir
+{
+public:
+    /// Capacity 0 keeps every state. Successors are needed by bootstrapped
+    /// targets only, samples for returns can go without them.
+    ReplayReservoir(size_t capacity, const RandomStream &random, bool keepSuccessors = true);
+
+    void offer(std::unique_ptr<QLearningState> state);
+
+    /// Kept states in stream order, the reservoir is left empty
+    std::vector<std::unique_ptr<QLearningState>> takeStates();
+
+    std::uint64_t offeredCount() const { return _offeredCount; }
+    size_t size() const { return _slots.size(); }
+
+protected:
+    struct Slot
+    {
+        std::uint64_t streamIndex;
+        std::unique_ptr<QLearningState> state;
+    };
+
+    static std::unique_ptr<QLearningState> copyAsSuccessor(const QLearningState &state);
+
+private:
+    size_t _capacity;
+    RandomStream _random;
+    bool _keepSuccessors;
+    std::uint64_t _offeredCount;
+    std::vector<Slot> _slots;
+    /// Slot of the last offered state if it was kept and waits for successor
+    size_t _waitingSlot;
+};
+
+}
+
+#endif // REPLAYRESERVOIR_H
@@ -0,0 +1,180 @@
+#include "ReplayShard.h"
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "BoardSignalConverter.h"
+
+namespace nn2048
+{
+
+namespace
+{
+
+const char ShardMagic[8] = { 'N', 'N', 'R', 'E', 'P', 'L', 'A', 'Y' };
+const std::uint32_t ShardVersion = 1;
+
+struct ShardHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint64_t recordCount;
+};
+
+static_assert(sizeof(ShardHeader) == 24, "Shard header layout is part of the file format");
+
+PackedBoard bitSignalToPackedBoard(const std::vector<double> &signal)
+{
+    const unsigned valuesPerTile = BoardSignalConverter::numberOfPossibleValues;
+    if (signal.size() != BoardSignalConverter::numberOfSignalBits)
+        throw std::runtime_error("Replay state board signal has unexpected size");
+
+    PackedBoard board = 0;
+    for (unsigned tile = 0; tile < BoardPacker::numberOfTiles; ++tile)
+        for (unsigned value = 0; value < valuesPerTile; ++value)
+            if (signal[tile * valuesPerTile + value] > 0.5)
+                board = BoardPacker::withExponent(board, tile, value + 1);
+    return board;
+}
+
+}
+
+ReplayRecord ReplayRecord::fromState(const QLearningState &state)
+{
+    ReplayRecord record;
+    record.board = bitSignalToPackedBoard(state.boardSignal());
+    record.reward = static_cast<float>(state.receivedReward());
+    record.action = static_cast<std::uint8_t>(state.takenAction());
+    record.flags = 0;
+    if (state.isInTerminalState())
+        record.flags |= TerminalRecordFlag;
+    if (state.hasMoveFailed())
+        record.flags |= MoveFailedRecordFlag;
+    if (state.isEpisodeEnd())
+        record.flags |= EpisodeEndRecordFlag;
+    record.count = 0;
+    return record;
+}
+
+ReplayShard::ReplayShard(const std::string &fileName):
+    _fileName(fileName),
+    _mapping(MAP_FAILED),
+    _mappingSize(0),
+    _records(nullptr),
+    _recordCount(0)
+{
+    int descriptor = ::open(fileName.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        throw std::runtime_error("Cannot open replay shard " + fileName);
+
+    struct stat fileStat;
+    if (::fstat(descriptor, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < sizeof(ShardHeader)) {
+        ::close(descriptor);
+        throw std::runtime_error(fileName + " is too small to be a replay shard");
+    }
+    _mappingSize = static_cast<size_t>(fileStat.st_size);
+    _mapping = ::mmap(nullptr, _mappingSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if (_mapping == MAP_FAILED)
+        throw std::runtime_error("Cannot map replay shard " + fileName);
+
+    ShardHeader header;
+    std::memcpy(&header, _mapping, sizeof(header));
+    if (std::memcmp(header.magic, ShardMagic, sizeof(ShardMagic)) != 0 || header.version != ShardVersion
+            || header.recordSize != sizeof(ReplayRecord)
+            || header.recordCount > (_mappingSize - sizeof(ShardHeader)) / sizeof(ReplayRecord)) {
+        ::munmap(_mapping, _mappingSize);
+        throw std::runtime_error(fileName + " is not a valid replay shard");
+    }
+    _records = reinterpret_cast<const ReplayRecord *>(static_cast<const char *>(_mapping) + sizeof(ShardHeader));
+    _recordCount = static_cast<size_t>(header.recordCount);
+    ::madvise(_mapping, _mappingSize, MADV_SEQUENTIAL);
+}
+
+ReplayShard::~ReplayShard()
+{
+    if (_mapping != MAP_FAILED)
+        ::munmap(_mapping, _mappingSize);
+}
+
+std::vector<float> ReplayShard::computeReturns(double gamma) const
+{
+    std::vector<float> returns(_recordCount);
+    double discountedReturn = 0.0;
+    for (size_t i = _recordCount; i > 0; --i) {
+        auto &record = _records[i - 1];
+        if (record.hasFlag(EpisodeEndRecordFlag) || record.hasFlag(TerminalRecordFlag))
+            discountedReturn = 0.0;
+        discountedReturn = record.reward + gamma * discountedReturn;
+        returns[i - 1] = static_cast<float>(discountedReturn);
+    }
+    return returns;
+}
+
+bool ReplayShard::isReplayShardFile(const std::string &fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    char magic[sizeof(ShardMagic)];
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, ShardMagic, sizeof(ShardMagic)) == 0;
+}
+
+ReplayShardWriter::ReplayShardWriter(const std::string &fileName, bool append):
+    _recordCount(0)
+{
+    if (append) {
+        ShardHeader header;
+        std::ifstream existing(fileName, std::ios::binary);
+        if (!existing.read(reinterpret_cast<char *>(&header), sizeof(header))
+                || std::memcmp(header.magic, ShardMagic, sizeof(ShardMagic)) != 0
+                || header.version != ShardVersion || header.recordSize != sizeof(ReplayRecord))
+            throw std::runtime_error("Cannot append to " + fileName + ", it is not a valid replay shard");
+        existing.close();
+
+        // Records past the header count come from an unfinished write and are overwritten
+        _recordCount = header.recordCount;
+        _file.open(fileName, std::ios::binary | std::ios::in | std::ios::out);
+        if (!_file)
+            throw std::runtime_error("Cannot open replay shard " + fileName);
+        _file.seekp(static_cast<std::streamoff>(sizeof(ShardHeader) + _recordCount * sizeof(ReplayRecord)));
+        return;
+    }
+
+    _file.open(fileName, std::ios::binary | std::ios::trunc);
+    if (!_file)
+        throw std::runtime_error("Cannot create replay shard " + fileName);
+
+    ShardHeader header;
+    std::memcpy(header.magic, ShardMagic, sizeof(ShardMagic));
+    header.version = ShardVersion;
+    header.recordSize = sizeof(ReplayRecord);
+    header.recordCount = 0;
+    _file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+ReplayShardWriter::~ReplayShardWriter()
+{
+    close();
+}
+
+void ReplayShardWriter::add(const ReplayRecord &record)
+{
+    _file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+    ++_recordCount;
+}
+
+bool ReplayShardWriter::close()
+{
+    if (!_file.is_open())
+        return true;
+    _file.seekp(static_cast<std::streamoff>(offsetof(ShardHeader, recordCount)));
+    _file.write(reinterpret_cast<const char *>(&_recordCount), sizeof(_recordCount));
+    bool succeeded = static_cast<bool>(_file);
+    _file.close();
+    return succeeded;
+}
+
+}
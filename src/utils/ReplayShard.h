@@ -0,0 +1,97 @@
+#ifndef REPLAYSHARD_H
+#define REPLAYSHARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "BoardPacker.h"
+#include "QLearningState.h"
+
+namespace nn2048
+{
+
+enum ReplayRecordFlags: std::uint8_t
+{
+    TerminalRecordFlag = 1,
+    MoveFailedRecordFlag = 2,
+    /// Last record of a game, returns are not carried over it
+    EpisodeEndRecordFlag = 4
+};
+
+/// Fixed size transition stored in binary replay shards
+struct ReplayRecord
+{
+    PackedBoard board;
+    float reward;
+    /// Game2048Core::Direction value
+    std::uint8_t action;
+    std::uint8_t flags;
+    /// Number of merged duplicates (see ReplayDeduplicator), 0 in plain
+    /// records. Saturates at the type maximum.
+    std::uint16_t count;
+
+    bool hasFlag(ReplayRecordFlags flag) const { return (flags & flag) != 0; }
+
+    static ReplayRecord fromState(const QLearningState &state);
+};
+
+static_assert(sizeof(ReplayRecord) == 16, "Replay record layout is part of the shard file format");
+
+/// Read-only, memory mapped binary replay file. Records are read straight
+/// from the mapping, so only touched pages occupy memory.
+class ReplayShard
+{
+public:
+    /// Maps the file, throws std::runtime_error when it is not a valid shard
+    explicit ReplayShard(const std::string &fileName);
+    ~ReplayShard();
+
+    ReplayShard(const ReplayShard &) = delete;
+    ReplayShard &operator = (const ReplayShard &) = delete;
+
+    static bool isReplayShardFile(const std::string &fileName);
+
+    size_t size() const { return _recordCount; }
+    const ReplayRecord &operator [](size_t index) const { return _records[index]; }
+    const ReplayRecord *begin() const { return _records; }
+    const ReplayRecord *end() const { return _records + _recordCount; }
+
+    const std::string &fileName() const { return _fileName; }
+
+    /// Discounted return of every record. Episodes end at terminal or episode
+    /// end records, shard end closes the last one.
+    std::vector<float> computeReturns(double gamma) const;
+
+private:
+    std::string _fileName;
+    void *_mapping;
+    size_t _mappingSize;
+    const ReplayRecord *_records;
+    size_t _recordCount;
+};
+
+/// Appends records to a binary replay file. Record count is written
+/// to the header when the writer is closed.
+class ReplayShardWriter
+{
+public:
+    /// Throws std::runtime_error when file cannot be created. Append keeps
+    /// records of an existing shard and adds new ones after them.
+    explicit ReplayShardWriter(const std::string &fileName, bool append = false);
+    ~ReplayShardWriter();
+
+    void add(const ReplayRecord &record);
+    bool close();
+
+    std::uint64_t recordCount() const { return _recordCount; }
+
+private:
+    std::ofstream _file;
+    std::uint64_t _recordCount;
+};
+
+}
+
+#endif // REPLAYSHARD_H
@@ -0,0 +1,105 @@
+#include "ReplayStream.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include "Logger.h"
+
+namespace nn2048
+{
+
+ReplayStream::ReplayStream(const std::vector<std::string> &shardFileNames, double gamma,
+                           size_t shuffleBufferSize, const RandomStream &random):
+    _fileNames(shardFileNames),
+    _gamma(gamma),
+    _shuffleBufferSize(std::max<size_t>(shuffleBufferSize, 1)),
+    _random(random),
+    _nextShard(0),
+    _currentRecord(0)
+{
+    _shuffleBuffer.reserve(_shuffleBufferSize);
+}
+
+ReplayStream::~ReplayStream()
+{
+    if (_prefetchedShard.valid())
+        _prefetchedShard.wait();
+}
+
+void ReplayStream::startEpoch()
+{
+    if (_prefetchedShard.valid())
+        _prefetchedShard.wait();
+
+    _shardOrder.resize(_fileNames.size());
+    std::iota(_shardOrder.begin(), _shardOrder.end(), 0);
+    std::shuffle(_shardOrder.begin(), _shardOrder.end(), _random);
+    _nextShard = 0;
+    _currentShard = LoadedShard();
+    _currentRecord = 0;
+    _shuffleBuffer.clear();
+    prefetchNextShard();
+}
+
+bool ReplayStream::next(TrainingSample &sample)
+{
+    TrainingSample incoming;
+    while (_shuffleBuffer.size() < _shuffleBufferSize && takeRecord(incoming))
+        _shuffleBuffer.push_back(incoming);
+    if (_shuffleBuffer.empty())
+        return false;
+
+    auto index = static_cast<size_t>(_random.nextIndex(_shuffleBuffer.size()));
+    sample = _shuffleBuffer[index];
+    _shuffleBuffer[index] = _shuffleBuffer.back();
+    _shuffleBuffer.pop_back();
+    return true;
+}
+
+ReplayStream::LoadedShard ReplayStream::loadShard(const std::string &fileName, double gamma)
+{
+    LoadedShard loaded;
+    loaded.shard = std::make_unique<ReplayShard>(fileName);
+    loaded.returns = loaded.shard->computeReturns(gamma);
+    return loaded;
+}
+
+void ReplayStream::prefetchNextShard()
+{
+    if (_nextShard >= _shardOrder.size())
+        return;
+    auto fileName = _fileNames[_shardOrder[_nextShard++]];
+    _prefetchedShard = std::async(std::launch::async, &ReplayStream::loadShard, fileName, _gamma);
+}
+
+bool ReplayStream::advanceShard()
+{
+    while (_prefetchedShard.valid()) {
+        try {
+            _currentShard = _prefetchedShard.get();
+            _currentRecord = 0;
+            prefetchNextShard();
+            return true;
+        } catch (std::runtime_error &exception) {
+            LOG_WARNING << "Replay shard omitted: " << exception.what();
+            prefetchNextShard();
+        }
+    }
+    _currentShard = LoadedShard();
+    return false;
+}
+
+bool ReplayStream::takeRecord(TrainingSample &sample)
+{
+    while (!_currentShard.shard || _currentRecord >= _currentShard.shard->size()) {
+        if (!advanceShard())
+            return false;
+    }
+    auto &record = (*_currentShard.shard)[_currentRecord];
+    sample.board = record.board;
+    sample.action = static_cast<Game2048Core::Direction>(record.action);
+    sample.target = _currentShard.returns[_currentRecord];
+    ++_currentRecord;
+    return true;
+}
+
+}
@@ -0,0 +1,70 @@
+#ifndef REPLAYSTREAM_H
+#define REPLAYSTREAM_H
+
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include <GameCore.h>
+#include "RandomService.h"
+#include "ReplayShard.h"
+
+namespace nn2048
+{
+
+struct TrainingSample
+{
+    PackedBoard board;
+    Game2048Core::Direction action;
+    double target;
+};
+
+/// Streams training samples from binary replay shards in random order
+/// without loading the corpus. Shards are visited in shuffled order, the
+/// next one is mapped and has its returns computed on a background thread,
+/// and samples pass through a bounded shuffle buffer. Memory use depends on
+/// shard and buffer size only.
+class ReplayStream
+{
+public:
+    ReplayStream(const std::vector<std::string> &shardFileNames, double gamma,
+                 size_t shuffleBufferSize, const RandomStream &random);
+    ~ReplayStream();
+
+    /// Starts new pass over all shards
+    void startEpoch();
+    /// Returns false when the epoch is over
+    bool next(TrainingSample &sample);
+
+    size_t shardCount() const { return _fileNames.size(); }
+
+protected:
+    struct LoadedShard
+    {
+        std::unique_ptr<ReplayShard> shard;
+        /// Discounted return of every record
+        std::vector<float> returns;
+    };
+
+    static LoadedShard loadShard(const std::string &fileName, double gamma);
+    void prefetchNextShard();
+    bool advanceShard();
+    bool takeRecord(TrainingSample &sample);
+
+private:
+    std::vector<std::string> _fileNames;
+    double _gamma;
+    size_t _shuffleBufferSize;
+    RandomStream _random;
+
+    std::vector<size_t> _shardOrder;
+    size_t _nextShard;
+    std::future<LoadedShard> _prefetchedShard;
+    LoadedShard _currentShard;
+    size_t _currentRecord;
+    std::vector<TrainingSample> _shuffleBuffer;
+};
+
+}
+
+#endif // REPLAYSTREAM_H
@@ -0,0 +1,230 @@
+#include "ReplayWriter.h"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <boost/filesystem.hpp>
+#include "BoardSignalConverter.h"
+#include "Fnv1a.h"
+
+namespace nn2048
+{
+
+namespace
+{
+
+const char JsonHead[] = "{\"states\":[";
+const char JsonTail[] = "],\"memorySize\":";
+/// Longest tail is the closing string, 20 digits and the closing brace
+const std::streamoff JsonTailMaxSize = sizeof(JsonTail) + 21;
+
+}
+
+std::unique_ptr<ReplayWriter> ReplayWriter::create(const std::string &fileName, bool append)
+{
+    if (boost::filesystem::path(fileName).extension() == ".bin")
+        return std::make_unique<ShardReplayWriter>(fileName, append);
+    return std::make_unique<JsonReplayWriter>(fileName, append);
+}
+
+JsonReplayWriter::JsonReplayWriter(const std::string &fileName, bool append)
+{
+    Json::StreamWriterBuilder builder;
+    builder.settings_["indentation"] = "";
+    _stateWriter.reset(builder.newStreamWriter());
+
+    if (append) {
+        seekToClosingTail(fileName);
+        return;
+    }
+
+    _file.open(fileName, std::ios::trunc);
+    if (!_file)
+        throw std::runtime_error("Cannot create replay memory file " + fileName);
+    // Size is known at the end only, object members can go in any order
+    _file << JsonHead;
+}
+
+void JsonReplayWriter::seekToClosingTail(const std::string &fileName)
+{
+    // Only the tail written by close() is recognized, other json files are rejected
+    std::ifstream existing(fileName, std::ios::binary | std::ios::ate);
+    if (!existing)
+        throw std::runtime_error("Cannot open replay memory file " + fileName);
+    std::streamoff fileSize = existing.tellg();
+    std::streamoff tailOffset = std::max<std::streamoff>(0, fileSize - JsonTailMaxSize);
+    std::string tail(static_cast<size_t>(fileSize - tailOffset), '\0');
+    existing.seekg(tailOffset);
+    existing.read(&tail[0], static_cast<std::streamsize>(tail.size()));
+
+    auto closingPosition = tail.rfind(JsonTail);
+    if (!existing || closingPosition == std::string::npos || tail.back() != '}')
+        throw std::runtime_error("Cannot append to " + fileName + ", it was not written by merge mode");
+    try {
+        _stateCount = std::stoull(tail.substr(closingPosition + sizeof(JsonTail) - 1));
+    } catch (std::logic_error &) {
+        throw std::runtime_error("Cannot append to " + fileName + ", memory size is not a number");
+    }
+    existing.close();
+
+    _file.open(fileName, std::ios::binary | std::ios::in | std::ios::out);
+    if (!_file)
+        throw std::runtime_error("Cannot open replay memory file " + fileName);
+    _file.seekp(tailOffset + static_cast<std::streamoff>(closingPosition));
+}
+
+JsonReplayWriter::~JsonReplayWriter()
+{
+    close();
+}
+
+void JsonReplayWriter::write(const QLearningState &state, bool episodeEnd)
+{
+    auto json = state.toJsonValue();
+    if (episodeEnd)
+        json["episodeEnd"] = true;
+    writeJson(json);
+}
+
+void JsonReplayWriter::writeRecord(const ReplayRecord &record)
+{
+    QLearningState state(BoardSignalConverter::packedBoardToBitSignal(record.board),
+                         static_cast<Game2048Core::Direction>(record.action),
+                         record.reward,
+                         record.hasFlag(MoveFailedRecordFlag),
+                         record.hasFlag(TerminalRecordFlag));
+    state.setEpisodeEnd(record.hasFlag(EpisodeEndRecordFlag));
+    auto json = state.toJsonValue();
+    if (record.count > 0)
+        json["count"] = record.count;
+    writeJson(json);
+}
+
+void JsonReplayWriter::writeJson(const Json::Value &json)
+{
+    if (_stateCount > 0)
+        _file << ',';
+    _stateWriter->write(json, &_file);
+    ++_stateCount;
+}
+
+bool JsonReplayWriter::close()
+{
+    if (!_file.is_open())
+        return true;
+    _file << JsonTail << _stateCount << '}';
+    bool succeeded = static_cast<bool>(_file);
+    _file.close();
+    return succeeded;
+}
+
+ShardReplayWriter::ShardReplayWriter(const std::string &fileName, bool append):
+    _writer(fileName, append)
+{
+    _stateCount = _writer.recordCount();
+}
+
+void ShardReplayWriter::write(const QLearningState &state, bool episodeEnd)
+{
+    auto record = ReplayRecord::fromState(state);
+    if (episodeEnd)
+        record.flags |= EpisodeEndRecordFlag;
+    _writer.add(record);
+    ++_stateCount;
+}
+
+void ShardReplayWriter::writeRecord(const ReplayRecord &record)
+{
+    _writer.add(record);
+    ++_stateCount;
+}
+
+bool ShardReplayWriter::close()
+{
+    return _writer.close();
+}
+
+ShardedReplayWriter::ShardedReplayWriter(const std::string &outputFileName, unsigned shardCount, bool append):
+    _outputFileName(outputFileName),
+    _currentShard(nullptr),
+    _closed(false)
+{
+    if (shardCount == 0)
+        throw std::runtime_error("Shard count cannot be 0");
+    for (unsigned shard = 0; shard < shardCount; ++shard) {
+        _shards.push_back(ReplayWriter::create(shardFileName(outputFileName, shard, shardCount), append));
+        _stateCount += _shards.back()->stateCount();
+    }
+    _currentShard = _shards.front().get();
+}
+
+ShardedReplayWriter::~ShardedReplayWriter()
+{
+    close();
+}
+
+std::string ShardedReplayWriter::shardFileName(const std::string &outputFileName, unsigned shard, unsigned shardCount)
+{
+    // Shard count in the name keeps outputs with different counts apart
+    boost::filesystem::path path(outputFileName);
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), "-%05u-of-%05u", shard, shardCount);
+    auto fileName = path.stem().string() + suffix + path.extension().string();
+    return (path.parent_path() / fileName).string();
+}
+
+void ShardedReplayWriter::beginEpisode(const std::string &episodeKey)
+{
+    // Shard assignment has to be the same on every platform and run
+    _currentShard = _shards[Fnv1a::hash(episodeKey) % _shards.size()].get();
+}
+
+void ShardedReplayWriter::write(const QLearningState &state, bool episodeEnd)
+{
+    _currentShard->write(state, episodeEnd);
+    ++_stateCount;
+}
+
+void ShardedReplayWriter::writeRecord(const ReplayRecord &record)
+{
+    std::uint64_t hash = (record.board ^ record.action) * 0x9E3779B97F4A7C15ULL;
+    _shards[(hash >> 32) % _shards.size()]->writeRecord(record);
+    ++_stateCount;
+}
+
+bool ShardedReplayWriter::close()
+{
+    if (_closed)
+        return true;
+    _closed = true;
+    bool succeeded = true;
+    for (auto &shard: _shards)
+        succeeded = shard->close() && succeeded;
+    return succeeded && writeIndex();
+}
+
+bool ShardedReplayWriter::writeIndex() const
+{
+    auto json = Json::Value(Json::objectValue);
+    auto shardsJson = Json::Value(Json::arrayValue);
+    auto shardCount = static_cast<unsigned>(_shards.size());
+    for (unsigned shard = 0; shard < shardCount; ++shard) {
+        auto shardJson = Json::Value(Json::objectValue);
+        auto fileName = shardFileName(_outputFileName, shard, shardCount);
+        shardJson["file"] = boost::filesystem::path(fileName).filename().string();
+        shardJson["states"] = static_cast<Json::UInt64>(_shards[shard]->stateCount());
+        shardsJson.append(shardJson);
+    }
+    json["shardCount"] = shardCount;
+    json["states"] = static_cast<Json::UInt64>(_stateCount);
+    json["shards"] = shardsJson;
+
+    std::ofstream file(indexFileNameFor(_outputFileName));
+    if (!file)
+        return false;
+    Json::StreamWriterBuilder builder;
+    std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+    writer->write(json, &file);
+    return static_cast<bool>(file);
+}
+
+}
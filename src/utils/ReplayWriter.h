@@ -0,0 +1,110 @@
+#ifndef REPLAYWRITER_H
+#define REPLAYWRITER_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <json/json.h>
+#include "QLearningState.h"
+#include "ReplayShard.h"
+
+namespace nn2048
+{
+
+/// Sequential replay output. States are written as they come, so memory use
+/// does not depend on the number of written states.
+class ReplayWriter
+{
+public:
+    virtual ~ReplayWriter() = default;
+
+    /// Binary shard writer for .bin file names, json writer otherwise. Append
+    /// continues a file written earlier by the same kind of writer.
+    /// Throws std::runtime_error when file cannot be created or continued.
+    static std::unique_ptr<ReplayWriter> create(const std::string &fileName, bool append = false);
+
+    /// Called before the first state of every episode. Key identifies the
+    /// episode, sharded writers pick the output shard by its hash.
+    virtual void beginEpisode(const std::string &episodeKey) { (void)episodeKey; }
+    /// Episode end is stored explicitly with the state
+    virtual void write(const QLearningState &state, bool episodeEnd) = 0;
+    /// Writes record as it is, json output stores its count field too
+    virtual void writeRecord(const ReplayRecord &record) = 0;
+    virtual bool close() = 0;
+
+    std::uint64_t stateCount() const { return _stateCount; }
+
+protected:
+    std::uint64_t _stateCount = 0;
+};
+
+/// Writes replay memory json readable by ReplayMemory(fileName)
+class JsonReplayWriter: public ReplayWriter
+{
+public:
+    JsonReplayWriter(const std::string &fileName, bool append);
+    ~JsonReplayWriter();
+
+    void write(const QLearningState &state, bool episodeEnd);
+    void writeRecord(const ReplayRecord &record);
+    bool close();
+
+protected:
+    void writeJson(const Json::Value &json);
+    void seekToClosingTail(const std::string &fileName);
+
+private:
+    std::ofstream _file;
+    std::unique_ptr<Json::StreamWriter> _stateWriter;
+};
+
+class ShardReplayWriter: public ReplayWriter
+{
+public:
+    ShardReplayWriter(const std::string &fileName, bool append);
+
+    void write(const QLearningState &state, bool episodeEnd);
+    void writeRecord(const ReplayRecord &record);
+    bool close();
+
+private:
+    ReplayShardWriter _writer;
+};
+
+/// Spreads whole episodes over a fixed number of shard files by hash of the
+/// episode key and writes a json index listing the shards. Shards can be
+/// read independently by parallel loaders and trainers.
+class ShardedReplayWriter: public ReplayWriter
+{
+public:
+    /// Shard files are named after the output file name and have its
+    /// extension, which selects their format. Throws std::runtime_error.
+    ShardedReplayWriter(const std::string &outputFileName, unsigned shardCount, bool append);
+    ~ShardedReplayWriter();
+
+    /// Index file name for output file name given to merge mode
+    static std::string indexFileNameFor(const std::string &outputFileName) { return outputFileName + ".index"; }
+    /// Output name with shard number inserted before the extension
+    static std::string shardFileName(const std::string &outputFileName, unsigned shard, unsigned shardCount);
+
+    void beginEpisode(const std::string &episodeKey);
+    void write(const QLearningState &state, bool episodeEnd);
+    /// Records are single state episodes, shard is picked by board and action
+    void writeRecord(const ReplayRecord &record);
+    bool close();
+
+protected:
+    bool writeIndex() const;
+
+private:
+    std::string _outputFileName;
+    std::vector<std::unique_ptr<ReplayWriter>> _shards;
+    ReplayWriter *_currentShard;
+    bool _closed;
+};
+
+}
+
+#endif // REPLAYWRITER_H
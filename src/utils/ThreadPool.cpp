@@ -0,0 +1,49 @@
+#include "ThreadPool.h"
+
+namespace nn2048
+{
+
+ThreadPool::ThreadPool(unsigned threadCount):
+    _stopping(false)
+{
+    if (threadCount == 0)
+        threadCount = hardwareThreadCount();
+    _workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+        _workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_tasksMutex);
+        _stopping = true;
+    }
+    _tasksCondition.notify_all();
+    for (auto &worker: _workers)
+        worker.join();
+}
+
+unsigned ThreadPool::hardwareThreadCount()
+{
+    unsigned count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+void ThreadPool::workerLoop()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_tasksMutex);
+            _tasksCondition.wait(lock, [this] () { return _stopping || !_tasks.empty(); });
+            if (_tasks.empty())
+                return;
+            task = std::move(_tasks.front());
+            _tasks.pop();
+        }
+        task();
+    }
+}
+
+}
@@ -0,0 +1,63 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace nn2048
+{
+
+/// Fixed number of worker threads executing submitted tasks in FIFO order.
+/// Destructor finishes queued tasks before joining workers.
+class ThreadPool
+{
+public:
+    /// Thread count 0 uses number of hardware threads
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator = (const ThreadPool &) = delete;
+
+    template<typename Function>
+    std::future<typename std::result_of<Function()>::type> submit(Function function);
+
+    unsigned threadCount() const { return static_cast<unsigned>(_workers.size()); }
+
+    static unsigned hardwareThreadCount();
+
+protected:
+    void workerLoop();
+
+private:
+    std::vector<std::thread> _workers;
+    std::queue<std::function<void()>> _tasks;
+    std::mutex _tasksMutex;
+    std::condition_variable _tasksCondition;
+    bool _stopping;
+};
+
+template<typename Function>
+std::future<typename std::result_of<Function()>::type> ThreadPool::submit(Function function)
+{
+    typedef typename std::result_of<Function()>::type Result;
+    // std::function needs copyable target, so packaged task is shared
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::move(function));
+    auto future = task->get_future();
+    {
+        std::lock_guard<std::mutex> lock(_tasksMutex);
+        _tasks.emplace([task] () { (*task)(); });
+    }
+    _tasksCondition.notify_one();
+    return future;
+}
+
+}
+
+#endif // THREADPOOL_H
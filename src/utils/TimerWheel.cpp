@@ -0,0 +1,92 @@
+#include "TimerWheel.h"
+#include <algorithm>
+
+namespace nn2048
+{
+
+TimerWheel::TimerWheel(std::chrono::milliseconds tick, size_t slotCount):
+    _tick(std::max(tick, std::chrono::milliseconds(1))),
+    _slots(std::max<size_t>(slotCount, 1)),
+    _currentSlot(0),
+    _pendingCount(0),
+    _stopping(false),
+    _firedCount(0),
+    _batchCount(0)
+{
+    _thread = std::thread(&TimerWheel::run, this);
+}
+
+TimerWheel::~TimerWheel()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _condition.notify_all();
+    _thread.join();
+}
+
+void TimerWheel::schedule(std::chrono::milliseconds delay, Callback callback)
+{
+    auto ticks = std::max<std::uint64_t>(1, static_cast<std::uint64_t>((delay + _tick - std::chrono::milliseconds(1)) / _tick));
+    bool wasIdle;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto slot = (_currentSlot + ticks) % _slots.size();
+        _slots[slot].push_back({ (ticks - 1) / _slots.size(), std::move(callback) });
+        wasIdle = _pendingCount++ == 0;
+    }
+    if (wasIdle)
+        _condition.notify_all();
+}
+
+size_t TimerWheel::pendingCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pendingCount;
+}
+
+void TimerWheel::run()
+{
+    std::vector<Callback> expired;
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _condition.wait(lock, [this] () { return _stopping || _pendingCount > 0; });
+        if (_stopping)
+            return;
+
+        // Ticks follow a fixed schedule, so callbacks taking long do not make the wheel late
+        auto nextTick = std::chrono::steady_clock::now() + _tick;
+        while (_pendingCount > 0) {
+            if (_condition.wait_until(lock, nextTick, [this] () { return _stopping; }))
+                return;
+            nextTick += _tick;
+            advance(expired);
+            if (expired.empty())
+                continue;
+
+            ++_batchCount;
+            _firedCount += expired.size();
+            lock.unlock();
+            for (auto &callback: expired)
+                callback();
+            expired.clear();
+            lock.lock();
+        }
+    }
+}
+
+void TimerWheel::advance(std::vector<Callback> &expired)
+{
+    _currentSlot = (_currentSlot + 1) % _slots.size();
+    auto &timers = _slots[_currentSlot];
+    auto waiting = std::partition(timers.begin(), timers.end(), [] (const Timer &timer) { return timer.laps == 0; });
+    for (auto timer = timers.begin(); timer != waiting; ++timer)
+        expired.push_back(std::move(timer->callback));
+    for (auto timer = waiting; timer != timers.end(); ++timer)
+        --timer->laps;
+    timers.erase(timers.begin(), waiting);
+    _pendingCount -= expired.size();
+}
+
+}
@@ -0,0 +1,71 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Defaults.h"
+
+namespace nn2048
+{
+
+/// Hashed timer wheel driven by one thread. Delays are rounded up to whole
+/// ticks and every slot holds timers of all its wheel laps, so scheduling is
+/// constant time. All timers expiring in a tick are fired together, one after
+/// another on the wheel thread, which should only hand work over. The thread
+/// sleeps while no timer is pending.
+class TimerWheel
+{
+public:
+    typedef std::function<void()> Callback;
+
+    TimerWheel(std::chrono::milliseconds tick = std::chrono::milliseconds(DefaultSchedulerTick),
+               size_t slotCount = DefaultSchedulerSlotCount);
+    /// Pending timers are dropped
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator = (const TimerWheel &) = delete;
+
+    void schedule(std::chrono::milliseconds delay, Callback callback);
+
+    size_t pendingCount() const;
+    std::uint64_t firedCount() const { return _firedCount; }
+    /// Number of ticks which fired at least one timer
+    std::uint64_t batchCount() const { return _batchCount; }
+
+protected:
+    struct Timer
+    {
+        /// Wheel laps left before the timer expires
+        std::uint64_t laps;
+        Callback callback;
+    };
+
+    void run();
+    /// Moves to the next slot and takes its expired timers
+    void advance(std::vector<Callback> &expired);
+
+private:
+    std::chrono::milliseconds _tick;
+    std::vector<std::vector<Timer>> _slots;
+    size_t _currentSlot;
+    size_t _pendingCount;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping;
+    std::thread _thread;
+
+    std::atomic<std::uint64_t> _firedCount;
+    std::atomic<std::uint64_t> _batchCount;
+};
+
+}
+
+#endif // TIMERWHEEL_H
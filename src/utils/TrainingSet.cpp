@@ -0,0 +1,41 @@
+#include "TrainingSet.h"
+#include <stdexcept>
+#include "Logger.h"
+
+namespace nn2048
+{
+
+std::unique_ptr<TrainingSet> TrainingSet::fromReplayMemory(const ReplayMemory &replayMemory)
+{
+    auto trainingSet = std::make_unique<TrainingSet>();
+    auto &states = replayMemory.states();
+    trainingSet->_records.reserve(states.size());
+    trainingSet->_targets.reserve(states.size());
+    for (auto &state: states) {
+        trainingSet->_records.push_back(ReplayRecord::fromState(*state));
+        trainingSet->_targets.push_back(static_cast<float>(state->discountedReturn()));
+    }
+    return trainingSet;
+}
+
+std::unique_ptr<TrainingSet> TrainingSet::fromShards(const std::vector<std::string> &fileNames, double gamma)
+{
+    auto trainingSet = std::make_unique<TrainingSet>();
+    bool anyValid = false;
+    for (auto &fileName: fileNames) {
+        try {
+            ReplayShard shard(fileName);
+            auto targets = shard.computeReturns(gamma);
+            trainingSet->_records.insert(trainingSet->_records.end(), shard.begin(), shard.end());
+            trainingSet->_targets.insert(trainingSet->_targets.end(), targets.begin(), targets.end());
+            anyValid = true;
+        } catch (std::runtime_error &exception) {
+            LOG_WARNING << "Replay shard omitted: " << exception.what();
+        }
+    }
+    if (!anyValid)
+        throw std::runtime_error("No valid replay shards");
+    return trainingSet;
+}
+
+}
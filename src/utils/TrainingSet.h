@@ -0,0 +1,35 @@
+#ifndef TRAININGSET_H
+#define TRAININGSET_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "ReplayMemory.h"
+#include "ReplayShard.h"
+
+namespace nn2048
+{
+
+/// Training samples built once for batch optimizers. Records of all sources
+/// are copied into one contiguous array next to their discounted returns, so
+/// samples are addressed directly by index.
+class TrainingSet
+{
+public:
+    /// Converts loaded states to compact records, targets are their discounted returns
+    static std::unique_ptr<TrainingSet> fromReplayMemory(const ReplayMemory &replayMemory);
+    /// Reads shards, throws std::runtime_error when none of them is valid
+    static std::unique_ptr<TrainingSet> fromShards(const std::vector<std::string> &fileNames, double gamma);
+
+    size_t size() const { return _targets.size(); }
+    const ReplayRecord &record(size_t index) const { return _records[index]; }
+    float target(size_t index) const { return _targets[index]; }
+
+private:
+    std::vector<ReplayRecord> _records;
+    std::vector<float> _targets;
+};
+
+}
+
+#endif // TRAININGSET_H
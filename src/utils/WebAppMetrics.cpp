@@ -0,0 +1,76 @@
+#include "WebAppMetrics.h"
+
+namespace nn2048
+{
+
+WebAppMetrics::WebAppMetrics()
+{
+    for (auto &session: _sessions) {
+        session.active.store(0, std::memory_order_relaxed);
+        session.moves.store(0, std::memory_order_relaxed);
+        session.games.store(0, std::memory_order_relaxed);
+        session.bestScore.store(0, std::memory_order_relaxed);
+    }
+}
+
+const char *WebAppMetrics::sessionTypeName(SessionType type)
+{
+    switch (type)
+    {
+    case SessionType::Keyboard:
+        return "keyboard";
+    case SessionType::Neural:
+        return "neural";
+    case SessionType::Expectimax:
+        return "expectimax";
+    case SessionType::Spectator:
+        return "spectator";
+    default:
+        return "unknown";
+    }
+}
+
+void WebAppMetrics::sessionStarted(SessionType type)
+{
+    counters(type).active.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WebAppMetrics::sessionEnded(SessionType type)
+{
+    counters(type).active.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void WebAppMetrics::moveMade(SessionType type)
+{
+    counters(type).moves.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WebAppMetrics::gameFinished(SessionType type, unsigned score)
+{
+    auto &session = counters(type);
+    session.games.fetch_add(1, std::memory_order_relaxed);
+    auto best = session.bestScore.load(std::memory_order_relaxed);
+    while (score > best && !session.bestScore.compare_exchange_weak(best, score, std::memory_order_relaxed));
+}
+
+std::int64_t WebAppMetrics::activeSessions(SessionType type) const
+{
+    return counters(type).active.load(std::memory_order_relaxed);
+}
+
+std::uint64_t WebAppMetrics::moves(SessionType type) const
+{
+    return counters(type).moves.load(std::memory_order_relaxed);
+}
+
+std::uint64_t WebAppMetrics::games(SessionType type) const
+{
+    return counters(type).games.load(std::memory_order_relaxed);
+}
+
+unsigned WebAppMetrics::bestScore(SessionType type) const
+{
+    return counters(type).bestScore.load(std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,55 @@
+#ifndef WEBAPPMETRICS_H
+#define WEBAPPMETRICS_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace nn2048
+{
+
+/// Counters of web application sessions. Sessions update them with relaxed
+/// atomics only, so instrumentation never waits on gameplay or on readers.
+class WebAppMetrics
+{
+public:
+    enum class SessionType
+    {
+        Keyboard,
+        Neural,
+        Expectimax,
+        Spectator,
+        Total
+    };
+
+    WebAppMetrics();
+
+    static const char *sessionTypeName(SessionType type);
+
+    void sessionStarted(SessionType type);
+    void sessionEnded(SessionType type);
+    void moveMade(SessionType type);
+    void gameFinished(SessionType type, unsigned score);
+
+    std::int64_t activeSessions(SessionType type) const;
+    std::uint64_t moves(SessionType type) const;
+    std::uint64_t games(SessionType type) const;
+    unsigned bestScore(SessionType type) const;
+
+private:
+    struct SessionCounters
+    {
+        std::atomic<std::int64_t> active;
+        std::atomic<std::uint64_t> moves;
+        std::atomic<std::uint64_t> games;
+        std::atomic<unsigned> bestScore;
+    };
+
+    SessionCounters &counters(SessionType type) { return _sessions[static_cast<unsigned>(type)]; }
+    const SessionCounters &counters(SessionType type) const { return _sessions[static_cast<unsigned>(type)]; }
+
+    SessionCounters _sessions[static_cast<unsigned>(SessionType::Total)];
+};
+
+}
+
+#endif // WEBAPPMETRICS_H
@@ -20,7 +20,9 @@ Wt::WColor GameBoardWidget::_darkFontColor = Wt::WColor(119, 110, 101);
 Wt::WColor GameBoardWidget::_lightFontColor = Wt::WColor(249, 246, 242);
 Wt::WFont GameBoardWidget::_font = Wt::WFont(Wt::FontFamily::SansSerif);
 
-GameBoardWidget::GameBoardWidget()
+GameBoardWidget::GameBoardWidget():
+    _dirtySlots(0),
+    _fullRepaintRequested(false)
 {
     resize(BOARD_SIZE, BOARD_SIZE);
     if (_colorMap.size() == 0)
@@ -33,12 +35,13 @@ void GameBoardWidget::setInitialTiles(TilePosition tile1, TilePosition tile2)
 {
     _tileMap[tile1] = INITIAL_TILE_VALUE;
     _tileMap[tile2] = INITIAL_TILE_VALUE;
-    update();
+    requestFullRepaint();
 }
 
 void GameBoardWidget::onReset()
 {
     _tileMap.clear();
+    requestFullRepaint();
 }
 
 void GameBoardWidget::onTileMoved(TilePosition from, TilePosition to, bool merged)
@@ -49,14 +52,15 @@ void GameBoardWidget::onTileMoved(TilePosition from, TilePosition to, bool merge
     if (!merged)
         _tileMap[to] = value;
     else _tileMap[to] += value;
-    update();
+    markDirty(from);
+    markDirty(to);
 }
 
 void GameBoardWidget::onTileCreated(unsigned int value, TilePosition position)
 {
     // TODO: add animation
     _tileMap[position] = value;
-    update();
+    markDirty(position);
 }
 
 void GameBoardWidget::onGameStateChanged(const GameState &state)
@@ -70,15 +74,77 @@ void GameBoardWidget::onGameStateChanged(const GameState &state)
                 _tileMap[{i, j}] = state.board[i][j].value();
         }
     }
-    update();
+    requestFullRepaint();
+}
+
+void GameBoardWidget::showBoard(PackedBoard board)
+{
+    for (unsigned int row = 0; row < TILE_ROWS; ++row)
+    {
+        for (unsigned int column = 0; column < TILES_PER_ROW; ++column)
+        {
+            TilePosition position { row, column };
+            auto exponent = BoardPacker::exponent(board, row * TILES_PER_ROW + column);
+            unsigned int value = exponent > 0 ? 1u << exponent : 0;
+            auto tile = _tileMap.find(position);
+            unsigned int shownValue = tile != _tileMap.end() ? tile->second : 0;
+            if (value == shownValue)
+                continue;
+            if (value > 0)
+                _tileMap[position] = value;
+            else
+                _tileMap.erase(tile);
+            markDirty(position);
+        }
+    }
 }
 
 void GameBoardWidget::paintEvent(Wt::WPaintDevice *device)
 {
     Wt::WPainter painter(device);
-    drawBackground(painter);
-    drawSlots(painter);
-    drawTiles(painter);
+    // Full repaint may follow an incremental update requested earlier in the
+    // same render, the opaque background covers what the client already has
+    if (device->paintFlags().test(Wt::PaintFlag::Update) && !_fullRepaintRequested)
+        drawDirtySlots(painter);
+    else
+    {
+        drawBackground(painter);
+        drawSlots(painter);
+        drawTiles(painter);
+    }
+    _dirtySlots = 0;
+    _fullRepaintRequested = false;
+}
+
+void GameBoardWidget::markDirty(const TilePosition &position)
+{
+    // All tile events of a move end up in one update
+    if (_dirtySlots == 0 && !_fullRepaintRequested)
+        update(Wt::PaintFlag::Update);
+    _dirtySlots |= 1u << (position.row * TILES_PER_ROW + position.column);
+}
+
+void GameBoardWidget::requestFullRepaint()
+{
+    _fullRepaintRequested = true;
+    update();
+}
+
+void GameBoardWidget::drawDirtySlots(Wt::WPainter &painter)
+{
+    for (unsigned int row = 0; row < TILE_ROWS; ++row)
+    {
+        for (unsigned int column = 0; column < TILES_PER_ROW; ++column)
+        {
+            if ((_dirtySlots & (1u << (row * TILES_PER_ROW + column))) == 0)
+                continue;
+            TilePosition position { row, column };
+            drawSlot(painter, slotPosition(position));
+            auto tile = _tileMap.find(position);
+            if (tile != _tileMap.end())
+                drawTile(painter, slotPosition(position), tile->second);
+        }
+    }
 }
 
 void GameBoardWidget::drawBackground(Wt::WPainter &painter)
@@ -90,29 +156,31 @@ void GameBoardWidget::drawBackground(Wt::WPainter &painter)
 
 void GameBoardWidget::drawSlots(Wt::WPainter &painter)
 {
-    // TODO: rounded corners
-    Wt::WColor color(205, 193, 180);
-    for (int i = 0; i < TILES_PER_ROW; ++i)
+    for (unsigned int i = 0; i < TILE_ROWS; ++i)
     {
-        double x = BORDER_SIZE + (TILE_SIZE + BORDER_SIZE) * i;
-        for (int j = 0; j < TILE_ROWS; ++j)
-        {
-            double y = BORDER_SIZE + (TILE_SIZE + BORDER_SIZE) * j;
-            painter.fillRect(x, y, TILE_SIZE, TILE_SIZE, color);
-        }
+        for (unsigned int j = 0; j < TILES_PER_ROW; ++j)
+            drawSlot(painter, slotPosition({ i, j }));
     }
 }
 
+void GameBoardWidget::drawSlot(Wt::WPainter &painter, const Wt::WPointF &position)
+{
+    // TODO: rounded corners
+    Wt::WColor color(205, 193, 180);
+    painter.fillRect(position.x(), position.y(), TILE_SIZE, TILE_SIZE, color);
+}
+
 void GameBoardWidget::drawTiles(Wt::WPainter &painter)
 {
     for (const auto &tile: _tileMap)
-    {
-        const TilePosition &pos = tile.first;
-        unsigned int value = tile.second;
-        double x = BORDER_SIZE + (TILE_SIZE + BORDER_SIZE) * pos.column;
-        double y = BORDER_SIZE + (TILE_SIZE + BORDER_SIZE) * pos.row;
-        drawTile(painter, Wt::WPointF(x, y), value);
-    }
+        drawTile(painter, slotPosition(tile.first), tile.second);
+}
+
+Wt::WPointF GameBoardWidget::slotPosition(const TilePosition &position)
+{
+    double x = BORDER_SIZE + (TILE_SIZE + BORDER_SIZE) * position.column;
+    double y = BORDER_SIZE + (TILE_SIZE + BORDER_SIZE) * position.row;
+    return Wt::WPointF(x, y);
 }
 
 void GameBoardWidget::drawTile(Wt::WPainter &painter, const Wt::WPointF &position, unsigned int value)
@@ -5,6 +5,7 @@
 #include <Tile.h>
 #include <GameCore.h>
 #include <map>
+#include "../utils/BoardPacker.h"
 #include "../utils/TilePositionComparer.h"
 
 namespace nn2048
@@ -15,6 +16,10 @@ using namespace Game2048Core;
 typedef std::map<TilePosition, unsigned int, TilePositionComparer> TileMap;
 typedef std::map<unsigned int, Wt::WColor> ColorMap;
 
+/// Draws the board on canvas. Tile events of one move only mark their slots
+/// dirty and the move is sent to the browser as a single incremental update
+/// redrawing these slots, the whole board is repainted only on reset, on
+/// state change or when the browser needs a full render.
 class GameBoardWidget : public Wt::WPaintedWidget
 {
 public:
@@ -26,14 +31,20 @@ public:
     void onTileMoved(TilePosition from, TilePosition to, bool merged);
     void onTileCreated(unsigned int value, TilePosition position);
     void onGameStateChanged(const GameState &state);
+    /// Shows packed board, only slots which differ from the shown board are redrawn
+    void showBoard(PackedBoard board);
 
 protected:
     void paintEvent(Wt::WPaintDevice *device);
+    void markDirty(const TilePosition &position);
+    void requestFullRepaint();
+    void drawDirtySlots(Wt::WPainter &painter);
     void drawBackground(Wt::WPainter &painter);
     void drawSlots(Wt::WPainter &painter);
     void drawSlot(Wt::WPainter &painter, const Wt::WPointF &position);
     void drawTiles(Wt::WPainter &painter);
     void drawTile(Wt::WPainter &painter, const Wt::WPointF &position, unsigned int value);
+    static Wt::WPointF slotPosition(const TilePosition &position);
 
     static void initializeColorMap();
     const Wt::WColor &tileColor(int value) const;
@@ -41,6 +52,9 @@ protected:
 
 private:
      TileMap _tileMap;
+     /// Bit per slot (row * 4 + column) changed since the last paint
+     unsigned int _dirtySlots;
+     bool _fullRepaintRequested;
      static ColorMap _colorMap;
      static Wt::WColor _transparentColor;
      static Wt::WColor _bigValueColor;
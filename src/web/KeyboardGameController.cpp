@@ -1,6 +1,6 @@
 #include "KeyboardGameController.h"
 #include <Wt/WEvent.h>
-#include <iostream>
+#include "../utils/Logger.h"
 
 namespace nn2048
 {
@@ -20,7 +20,7 @@ void KeyboardGameController::onKeyDown(const Wt::WKeyEvent &event)
     if (dir != Direction::None)
     {
         if (!_gameCore->tryMove(dir))
-            std::cout << "KeyboardGameController::onKeyDown: couldn't move tiles" << std::endl;
+            LOG_DEBUG << "KeyboardGameController::onKeyDown: couldn't move tiles";
     }
     else if (event.key() == Wt::Key::R)
         _gameCore->reset();
@@ -28,9 +28,9 @@ void KeyboardGameController::onKeyDown(const Wt::WKeyEvent &event)
     {
         if (_stateTracker)
             _stateTracker->undoLastMove();
-        else std::cout << "KeyboardGameController::onKeyDown: no state tracker to undo move" << std::endl;
+        else LOG_DEBUG << "KeyboardGameController::onKeyDown: no state tracker to undo move";
     }
-    else std::cout << "KeyboardGameController::onKeyDown: unknown input" << std::endl;
+    else LOG_DEBUG << "KeyboardGameController::onKeyDown: unknown input";
 }
 
 void KeyboardGameController::initializeTranslationMap()
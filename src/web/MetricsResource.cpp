@@ -0,0 +1,133 @@
+#include "MetricsResource.h"
+#include <ostream>
+#include <Wt/Http/Request.h>
+#include <Wt/Http/Response.h>
+
+namespace nn2048
+{
+
+namespace
+{
+
+void writeHeader(std::ostream &out, const char *name, const char *type, const char *help)
+{
+    out << "# HELP " << name << " " << help << "\n"
+        << "# TYPE " << name << " " << type << "\n";
+}
+
+template <typename T>
+void writeValue(std::ostream &out, const char *name, const char *type, const char *help, T value)
+{
+    writeHeader(out, name, type, help);
+    out << name << " " << value << "\n";
+}
+
+}
+
+MetricsResource::MetricsResource(WebAppMetrics *metrics,
+                                 const InferenceService *inferenceService,
+                                 const ReplayRecorder *replayRecorder,
+                                 const SpectatorChannel *spectatorChannel,
+                                 const TimerWheel *scheduler):
+    _metrics(metrics),
+    _inferenceService(inferenceService),
+    _replayRecorder(replayRecorder),
+    _spectatorChannel(spectatorChannel),
+    _scheduler(scheduler)
+{
+}
+
+MetricsResource::~MetricsResource()
+{
+    beingDeleted();
+}
+
+void MetricsResource::handleRequest(const Wt::Http::Request &, Wt::Http::Response &response)
+{
+    response.setMimeType("text/plain; version=0.0.4");
+    auto &out = response.out();
+    if (_metrics)
+        writeSessionMetrics(out);
+    if (_inferenceService)
+        writeInferenceMetrics(out);
+    if (_replayRecorder)
+        writeRecorderMetrics(out);
+    if (_spectatorChannel)
+        writeValue(out, "nn2048_spectator_subscribers", "gauge",
+                   "Sessions watching the broadcast game", _spectatorChannel->subscriberCount());
+    if (_scheduler)
+        writeValue(out, "nn2048_scheduler_pending_timers", "gauge",
+                   "Timers waiting in the move scheduler", _scheduler->pendingCount());
+}
+
+void MetricsResource::writeSessionMetrics(std::ostream &out)
+{
+    typedef WebAppMetrics::SessionType SessionType;
+    const SessionType types[] = { SessionType::Keyboard, SessionType::Neural, SessionType::Expectimax, SessionType::Spectator };
+
+    writeHeader(out, "nn2048_active_sessions", "gauge", "Open sessions by controller type");
+    for (auto type: types)
+        out << "nn2048_active_sessions{controller=\"" << WebAppMetrics::sessionTypeName(type) << "\"} "
+            << _metrics->activeSessions(type) << "\n";
+
+    writeHeader(out, "nn2048_moves_total", "counter", "Moves made by controller type");
+    for (auto type: types)
+        out << "nn2048_moves_total{controller=\"" << WebAppMetrics::sessionTypeName(type) << "\"} "
+            << _metrics->moves(type) << "\n";
+
+    writeHeader(out, "nn2048_games_total", "counter", "Finished games by controller type");
+    for (auto type: types)
+        out << "nn2048_games_total{controller=\"" << WebAppMetrics::sessionTypeName(type) << "\"} "
+            << _metrics->games(type) << "\n";
+
+    writeHeader(out, "nn2048_best_score", "gauge", "Best finished game score by controller type");
+    for (auto type: types)
+        out << "nn2048_best_score{controller=\"" << WebAppMetrics::sessionTypeName(type) << "\"} "
+            << _metrics->bestScore(type) << "\n";
+}
+
+void MetricsResource::writeInferenceMetrics(std::ostream &out)
+{
+    writeValue(out, "nn2048_inference_requests_total", "counter",
+               "Boards evaluated by the inference service", _inferenceService->requestCount());
+    writeValue(out, "nn2048_inference_batches_total", "counter",
+               "Evaluator calls made by the inference service", _inferenceService->batchCount());
+
+    // Histogram buckets are cumulative in the exposition format
+    auto &histogram = _inferenceService->latencyHistogram();
+    auto &bounds = LatencyHistogram::bucketBounds();
+    writeHeader(out, "nn2048_inference_latency_seconds", "histogram", "Time from request until move values are ready");
+    std::uint64_t cumulative = 0;
+    for (size_t i = 0; i < LatencyHistogram::bucketCount; ++i) {
+        cumulative += histogram.bucket(i);
+        out << "nn2048_inference_latency_seconds_bucket{le=\"";
+        if (i < bounds.size())
+            out << static_cast<double>(bounds[i]) / 1e6;
+        else
+            out << "+Inf";
+        out << "\"} " << cumulative << "\n";
+    }
+    out << "nn2048_inference_latency_seconds_sum " << static_cast<double>(histogram.sumMicroseconds()) / 1e6 << "\n"
+        << "nn2048_inference_latency_seconds_count " << histogram.count() << "\n";
+}
+
+void MetricsResource::writeRecorderMetrics(std::ostream &out)
+{
+    auto statistics = _replayRecorder->statistics();
+    writeValue(out, "nn2048_recorder_queue_depth", "gauge",
+               "Games waiting for the recorder writer", statistics.queueDepth);
+    writeValue(out, "nn2048_recorder_queue_max_depth", "gauge",
+               "Highest recorder queue depth seen", statistics.maxQueueDepth);
+    writeValue(out, "nn2048_recorder_queue_capacity", "gauge",
+               "Recorder queue capacity", statistics.queueCapacity);
+    writeValue(out, "nn2048_recorder_dropped_games_total", "counter",
+               "Games dropped because the recorder queue was full", statistics.droppedGames);
+    writeValue(out, "nn2048_recorder_written_games_total", "counter",
+               "Games written to replay files", statistics.writtenGames);
+    writeValue(out, "nn2048_recorder_raw_bytes_total", "counter",
+               "Uncompressed bytes of written replay records", statistics.rawBytes);
+    writeValue(out, "nn2048_recorder_written_bytes_total", "counter",
+               "Compressed bytes written to replay files", statistics.compressedBytes);
+}
+
+}
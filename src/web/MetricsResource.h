@@ -0,0 +1,44 @@
+#ifndef METRICSRESOURCE_H
+#define METRICSRESOURCE_H
+
+#include <Wt/WResource.h>
+#include "../utils/InferenceService.h"
+#include "../utils/ReplayRecorder.h"
+#include "../utils/TimerWheel.h"
+#include "../utils/WebAppMetrics.h"
+#include "SpectatorChannel.h"
+
+namespace nn2048
+{
+
+/// Serves counters of the running web application in Prometheus text format.
+/// Only reads counters, so scraping never blocks game sessions. Services not
+/// running (null pointers) are omitted from the output.
+class MetricsResource : public Wt::WResource
+{
+public:
+    MetricsResource(WebAppMetrics *metrics,
+                    const InferenceService *inferenceService,
+                    const ReplayRecorder *replayRecorder,
+                    const SpectatorChannel *spectatorChannel,
+                    const TimerWheel *scheduler);
+    ~MetricsResource();
+
+    void handleRequest(const Wt::Http::Request &request, Wt::Http::Response &response) override;
+
+protected:
+    void writeSessionMetrics(std::ostream &out);
+    void writeInferenceMetrics(std::ostream &out);
+    void writeRecorderMetrics(std::ostream &out);
+
+private:
+    WebAppMetrics *_metrics;
+    const InferenceService *_inferenceService;
+    const ReplayRecorder *_replayRecorder;
+    const SpectatorChannel *_spectatorChannel;
+    const TimerWheel *_scheduler;
+};
+
+}
+
+#endif // METRICSRESOURCE_H
@@ -1,70 +1,129 @@
 #include "NeuralNetworkGameController.h"
+#include <Wt/WApplication.h>
+#include <Wt/WServer.h>
 #include <Wt/WTimer.h>
-#include <iostream>
 #include <chrono>
 #include <functional>
 #include <map>
-#include "../utils/BoardSignalConverter.h"
+#include "../utils/BoardPacker.h"
+#include "../utils/Logger.h"
 #include "../utils/NetworkOutputConverter.h"
 
 namespace nn2048
 {
 
 NeuralNetworkGameController::NeuralNetworkGameController(GameCore *gameCore,
-                                                         const NeuralNetwork::Network *network,
-                                                         bool autoRestart):
+                                                         const BoardEvaluator *evaluator,
+                                                         InferenceService *inferenceService,
+                                                         std::unique_ptr<ExpectimaxSearch> search,
+                                                         bool autoRestart,
+                                                         TimerWheel *scheduler,
+                                                         std::chrono::milliseconds moveDelay):
     GameController(gameCore),
-    _network(network),
-    _autoRestart(autoRestart)
+    _evaluator(evaluator),
+    _inferenceService(inferenceService),
+    _search(std::move(search)),
+    _autoRestart(autoRestart),
+    _scheduler(scheduler),
+    _moveDelay(moveDelay)
 {}
 
 void NeuralNetworkGameController::start()
 {
-    std::clog << "NeuralNetworkGameController: starting" << std::endl;
-    Wt::WTimer::singleShot(std::chrono::milliseconds(500), [this] (){
-        move();
-    });
+    LOG_DEBUG << "NeuralNetworkGameController: starting";
+    if (!_scheduler)
+    {
+        Wt::WTimer::singleShot(_moveDelay, [this] (){
+            move();
+        });
+        return;
+    }
+
+    // Scheduler fires moves of all sessions due in a tick together, so their
+    // inference requests meet in the same batch
+    auto sessionId = Wt::WApplication::instance()->sessionId();
+    auto postMove = [this, sessionId] () {
+        Wt::WServer::instance()->post(sessionId, [this] () {
+            move();
+            Wt::WApplication::instance()->triggerUpdate();
+        });
+    };
+    if (_moveDelay.count() == 0)
+        postMove();
+    else
+        _scheduler->schedule(_moveDelay, postMove);
 }
 
 void NeuralNetworkGameController::move()
 {
-    static std::map<Direction, std::string> directionDictionary {
-        { Direction::Up, "up" },
-        { Direction::Down, "down" },
-        { Direction::Left, "left" },
-        { Direction::Right, "right" }
-    };
-
-    std::clog << "NeuralNetworkGameController::move()" << std::endl;
+    LOG_DEBUG << "NeuralNetworkGameController::move()";
 
     if (_gameCore->isGameOver())
     {
-        std::clog << "Game over." << std::endl;
+        LOG_DEBUG << "Game over.";
         if (_autoRestart)
         {
-            std::clog <<  "Restarting." << std::endl;
+            LOG_DEBUG << "Restarting.";
             _gameCore->reset();
             start();
         }
         return;
     }
 
-    auto boardSignal = BoardSignalConverter::boardToSignal(_gameCore->board());
-    auto response = _network->responses(boardSignal);
-    auto directions = NetworkOutputConverter::outputToMoves(response);
+    if (_inferenceService && !_search)
+        requestMoves();
+    else
+        tryMoves(rankMoves());
+}
+
+void NeuralNetworkGameController::requestMoves()
+{
+    auto board = BoardPacker::pack(_gameCore->board());
+    auto sessionId = Wt::WApplication::instance()->sessionId();
+    _inferenceService->submit(board, [this, sessionId] (const std::vector<double> &values) {
+        // Runs on inference thread, the move is applied inside the session.
+        // Requests of sessions which have ended meanwhile are dropped.
+        Wt::WServer::instance()->post(sessionId, [this, values] () {
+            if (values.empty())
+                start();
+            else
+                tryMoves(NetworkOutputConverter::outputToMoves(values));
+            Wt::WApplication::instance()->triggerUpdate();
+        });
+    });
+}
+
+void NeuralNetworkGameController::tryMoves(const DirectionSignalVector &directions)
+{
+    static std::map<Direction, std::string> directionDictionary {
+        { Direction::Up, "up" },
+        { Direction::Down, "down" },
+        { Direction::Left, "left" },
+        { Direction::Right, "right" }
+    };
+
     for (auto direction: directions)
     {
-        std::clog << "Trying direction " << directionDictionary[direction.first] << " (" << direction.second << ")... ";
-        if (_gameCore->tryMove(direction.first))
+        bool moved = _gameCore->tryMove(direction.first);
+        LOG_DEBUG << "Trying direction " << directionDictionary[direction.first] << " (" << direction.second << ")... "
+                  << (moved ? "ok" : "failed");
+        if (moved)
         {
-            std::clog << "ok" << std::endl;
             start();
             break;
         }
-        else
-            std::clog << "failed" << std::endl;
     }
 }
 
+DirectionSignalVector NeuralNetworkGameController::rankMoves() const
+{
+    auto board = BoardPacker::pack(_gameCore->board());
+    if (_search)
+        return _search->rankMoves(board);
+
+    std::vector<double> values;
+    _evaluator->evaluateMoves({ board }, values);
+    return NetworkOutputConverter::outputToMoves(values);
 }
 
+}
@@ -2,7 +2,11 @@
 #define NEURALNETWORKGAMECONTROLLER_H
 
 #include "GameController.h"
-#include <Network.h>
+#include <memory>
+#include "../utils/BoardEvaluator.h"
+#include "../utils/ExpectimaxSearch.h"
+#include "../utils/InferenceService.h"
+#include "../utils/TimerWheel.h"
 
 namespace nn2048
 {
@@ -10,16 +14,33 @@ namespace nn2048
 class NeuralNetworkGameController : public GameController
 {
 public:
+    /// Moves are picked greedily by evaluator unless search is given.
+    /// Greedy moves are evaluated by the shared inference service when given.
+    /// Moves follow each other after move delay, timed by the shared scheduler
+    /// when given, delay 0 plays moves right after each other.
     NeuralNetworkGameController(GameCore *game,
-                                const NeuralNetwork::Network *network,
-                                bool autoRestart);
+                                const BoardEvaluator *evaluator,
+                                InferenceService *inferenceService,
+                                std::unique_ptr<ExpectimaxSearch> search,
+                                bool autoRestart,
+                                TimerWheel *scheduler = nullptr,
+                                std::chrono::milliseconds moveDelay = std::chrono::milliseconds(DefaultMoveDelay));
 
     void start();
     void move();
 
+protected:
+    DirectionSignalVector rankMoves() const;
+    void requestMoves();
+    void tryMoves(const DirectionSignalVector &directions);
+
 private:
-    const NeuralNetwork::Network *_network;
+    const BoardEvaluator *_evaluator;
+    InferenceService *_inferenceService;
+    std::unique_ptr<ExpectimaxSearch> _search;
     bool _autoRestart;
+    TimerWheel *_scheduler;
+    std::chrono::milliseconds _moveDelay;
 };
 
 
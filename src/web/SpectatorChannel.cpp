@@ -0,0 +1,133 @@
+#include "SpectatorChannel.h"
+#include <Wt/WServer.h>
+#include <vector>
+#include "../utils/BoardPacker.h"
+#include "../utils/NetworkOutputConverter.h"
+
+#define GAME_BOARD_SIZE 4
+
+namespace nn2048
+{
+
+namespace
+{
+
+/// Final board stays on screen for this many move intervals
+const unsigned gameOverPauseTicks = 6;
+
+}
+
+SpectatorChannel::SpectatorChannel(const BoardEvaluator *evaluator, std::chrono::milliseconds moveInterval):
+    _evaluator(evaluator),
+    _moveInterval(moveInterval),
+    _gameCore(std::make_unique<Game2048Core::GameCore>(GAME_BOARD_SIZE)),
+    _gameOverTicks(0),
+    _nextSubscription(1),
+    _stopping(false)
+{
+    _frame.board = BoardPacker::pack(_gameCore->board());
+    _thread = std::thread(&SpectatorChannel::play, this);
+}
+
+SpectatorChannel::~SpectatorChannel()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _condition.notify_all();
+    _thread.join();
+}
+
+unsigned long SpectatorChannel::subscribe(const std::string &sessionId, FrameHandler handler, SpectatorFrame &snapshot)
+{
+    unsigned long subscription;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        subscription = _nextSubscription++;
+        _subscribers[subscription] = { sessionId, std::move(handler) };
+        snapshot = _frame;
+    }
+    // First viewer resumes the game
+    _condition.notify_all();
+    return subscription;
+}
+
+void SpectatorChannel::unsubscribe(unsigned long subscription)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _subscribers.erase(subscription);
+}
+
+size_t SpectatorChannel::subscriberCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _subscribers.size();
+}
+
+void SpectatorChannel::play()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        // Nobody watches, nothing is played
+        _condition.wait(lock, [this] () { return _stopping || !_subscribers.empty(); });
+        if (_condition.wait_for(lock, _moveInterval, [this] () { return _stopping; }))
+            return;
+        if (_subscribers.empty())
+            continue;
+
+        // Game is only touched by this thread, subscribers wait just for the frame
+        lock.unlock();
+        advance();
+        lock.lock();
+    }
+}
+
+void SpectatorChannel::advance()
+{
+    if (_gameCore->isGameOver()) {
+        if (++_gameOverTicks < gameOverPauseTicks)
+            return;
+        _gameOverTicks = 0;
+        _gameCore->reset();
+    } else {
+        std::vector<double> values;
+        _evaluator->evaluateMoves({ BoardPacker::pack(_gameCore->board()) }, values);
+        for (auto direction: NetworkOutputConverter::outputToMoves(values)) {
+            if (_gameCore->tryMove(direction.first))
+                break;
+        }
+    }
+
+    SpectatorFrame frame;
+    frame.board = BoardPacker::pack(_gameCore->board());
+    frame.score = _gameCore->score();
+    frame.gameOver = _gameCore->isGameOver();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        frame.moveCount = _frame.moveCount + 1;
+        _frame = frame;
+    }
+    broadcast(frame);
+}
+
+void SpectatorChannel::broadcast(const SpectatorFrame &frame)
+{
+    std::vector<Subscriber> subscribers;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        subscribers.reserve(_subscribers.size());
+        for (auto &subscriber: _subscribers)
+            subscribers.push_back(subscriber.second);
+    }
+    // Posts to sessions which have ended meanwhile are dropped by the server
+    auto server = Wt::WServer::instance();
+    for (auto &subscriber: subscribers) {
+        auto handler = subscriber.handler;
+        server->post(subscriber.sessionId, [handler, frame] () {
+            handler(frame);
+        });
+    }
+}
+
+}
@@ -0,0 +1,79 @@
+#ifndef SPECTATORCHANNEL_H
+#define SPECTATORCHANNEL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <GameCore.h>
+#include "../utils/BoardEvaluator.h"
+
+namespace nn2048
+{
+
+/// Board of the broadcast game after a move
+struct SpectatorFrame
+{
+    PackedBoard board = 0;
+    unsigned score = 0;
+    unsigned long moveCount = 0;
+    bool gameOver = false;
+};
+
+/// One game played greedily by the network on a server thread and watched by
+/// any number of sessions. Every move is posted to all subscribed sessions
+/// with server push, so the cost of the game does not grow with viewers.
+/// The game advances only while somebody watches and restarts shortly after
+/// it is over.
+class SpectatorChannel
+{
+public:
+    typedef std::function<void(const SpectatorFrame &frame)> FrameHandler;
+
+    SpectatorChannel(const BoardEvaluator *evaluator, std::chrono::milliseconds moveInterval);
+    ~SpectatorChannel();
+
+    SpectatorChannel(const SpectatorChannel &) = delete;
+    SpectatorChannel &operator = (const SpectatorChannel &) = delete;
+
+    /// Handler is invoked inside the session with every following frame.
+    /// Current frame is stored to snapshot, so late joiners start from the
+    /// board being played. Returns subscription id for unsubscribe().
+    unsigned long subscribe(const std::string &sessionId, FrameHandler handler, SpectatorFrame &snapshot);
+    void unsubscribe(unsigned long subscription);
+
+    size_t subscriberCount() const;
+
+protected:
+    struct Subscriber
+    {
+        std::string sessionId;
+        FrameHandler handler;
+    };
+
+    void play();
+    void advance();
+    void broadcast(const SpectatorFrame &frame);
+
+private:
+    const BoardEvaluator *_evaluator;
+    std::chrono::milliseconds _moveInterval;
+    std::unique_ptr<Game2048Core::GameCore> _gameCore;
+    unsigned _gameOverTicks;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    std::map<unsigned long, Subscriber> _subscribers;
+    unsigned long _nextSubscription;
+    SpectatorFrame _frame;
+    bool _stopping;
+    std::thread _thread;
+};
+
+}
+
+#endif // SPECTATORCHANNEL_H
@@ -3,6 +3,8 @@
 #include <GameHistorySerializer.h>
 #include <Wt/WDateTime.h>
 #include <Wt/WEnvironment.h>
+#include "../utils/BoardPacker.h"
+#include "../utils/Logger.h"
 #include "GameWidget.h"
 #include "KeyboardGameController.h"
 #include "NeuralNetworkGameController.h"
@@ -17,19 +19,35 @@
 static const std::string ControllerParameterName = "controller";
 static const std::string KeyboardControllerValue = "keyboard";
 static const std::string NeuralNetworkControllerValue = "neural";
+static const std::string ExpectimaxControllerValue = "expectimax";
+static const std::string SpectatorControllerValue = "spectator";
 static const std::string RestartParameterName = "restart";
 static const std::string AutoRestartValue = "auto";
+static const std::string MoveDelayParameterName = "delay";
+static const std::string FastForwardValue = "fast";
 
 using namespace Game2048Core;
 
 namespace nn2048
 {
 
-WebApplication::WebApplication(const Wt::WEnvironment &env, const NeuralNetwork::Network *network, unsigned long highscoreThreshold):
+WebApplication::WebApplication(const Wt::WEnvironment &env,
+                               const BoardEvaluator *evaluator,
+                               InferenceService *inferenceService,
+                               const ExpectimaxSettings &searchSettings,
+                               unsigned long highscoreThreshold,
+                               ReplayRecorder *replayRecorder,
+                               SpectatorChannel *spectatorChannel,
+                               TimerWheel *scheduler,
+                               WebAppMetrics *metrics):
     Wt::WApplication(env),
     _highscoreThreshold(highscoreThreshold),
+    _replayRecorder(replayRecorder),
+    _spectatorChannel(nullptr),
+    _spectatorSubscription(0),
+    _metrics(metrics),
+    _sessionType(WebAppMetrics::SessionType::Keyboard),
     _gameCore(std::make_unique<GameCore>(GAME_BOARD_SIZE)),
-    _gameStateTracker(std::make_unique<GameStateTracker>(_gameCore.get())),
     _replayMemoryTracker(std::make_unique<ReplayMemoryTracker>(_gameCore.get()))
 {
     setTitle("Bastard - 2048 game played by neural network");
@@ -39,7 +57,7 @@ WebApplication::WebApplication(const Wt::WEnvironment &env, const NeuralNetwork:
     _gameWidget = root()->addWidget(std::make_unique<GameWidget>());
     _gameWidget->headerWidget()->setBestScore(getBestScoreCookie());
 
-    setupGameController(network);
+    setupGameController(evaluator, inferenceService, searchSettings, spectatorChannel, scheduler);
 
     _gameCore->onBeingReset.connect([this] () {
         serializeReplayMemory();
@@ -57,40 +75,134 @@ WebApplication::WebApplication(const Wt::WEnvironment &env, const NeuralNetwork:
     });
     _gameCore->onGameOver.connect([this] () {
         serializeReplayMemory();
+        if (_metrics)
+            _metrics->gameFinished(_sessionType, _gameCore->score());
+    });
+    _gameCore->onTilesMoved.connect([this] (Direction, bool succeeded) {
+        if (succeeded && _metrics)
+            _metrics->moveMade(_sessionType);
     });
     _gameCore->onScoreUpdated.connect([this] (unsigned int score) {
         scoreUpdated(score);
     });
 
-    showInitialTiles();
+    // Spectators see the broadcast board instead of their own game
+    if (!_spectatorChannel)
+        showInitialTiles();
+
+    if (_metrics)
+        _metrics->sessionStarted(_sessionType);
+}
+
+WebApplication::~WebApplication()
+{
+    if (_metrics)
+        _metrics->sessionEnded(_sessionType);
+    if (_spectatorChannel)
+        _spectatorChannel->unsubscribe(_spectatorSubscription);
+}
+
+PackedBoard WebApplication::board() const
+{
+    return BoardPacker::pack(_gameCore->board());
 }
 
-void WebApplication::setupGameController(const NeuralNetwork::Network *network)
+bool WebApplication::playMove(Direction direction)
+{
+    bool moved = _gameCore->tryMove(direction);
+    if (_gameCore->isGameOver())
+        _gameCore->reset();
+    return moved;
+}
+
+void WebApplication::setupGameController(const BoardEvaluator *evaluator, InferenceService *inferenceService,
+                                         const ExpectimaxSettings &searchSettings, SpectatorChannel *spectatorChannel,
+                                         TimerWheel *scheduler)
 {
     auto param = environment().getParameter(ControllerParameterName);
-    if (param && *param == NeuralNetworkControllerValue && network)
-        setupNeuralNetworkGameController(network);
+    if (param && *param == SpectatorControllerValue && spectatorChannel)
+    {
+        _sessionType = WebAppMetrics::SessionType::Spectator;
+        setupSpectator(spectatorChannel);
+        return;
+    }
+    if (param && *param == NeuralNetworkControllerValue && evaluator)
+    {
+        _sessionType = WebAppMetrics::SessionType::Neural;
+        setupNeuralNetworkGameController(evaluator, inferenceService, nullptr, scheduler);
+    }
+    else if (param && *param == ExpectimaxControllerValue && evaluator)
+    {
+        _sessionType = WebAppMetrics::SessionType::Expectimax;
+        setupNeuralNetworkGameController(evaluator, nullptr, std::make_unique<ExpectimaxSearch>(evaluator, searchSettings), scheduler);
+    }
     else setupKeyboardGameController();
 }
 
 void WebApplication::setupKeyboardGameController()
 {
+    // Only players can undo moves, network controlled sessions keep no history
+    _gameStateTracker = std::make_unique<GameStateTracker>(_gameCore.get());
     KeyboardGameController *controller = this->addChild(std::make_unique<KeyboardGameController>(_gameCore.get(), _gameStateTracker.get()));
     _gameController = controller;
     globalKeyWentDown().connect(controller, &KeyboardGameController::onKeyDown);
 }
 
-void WebApplication::setupNeuralNetworkGameController(const NeuralNetwork::Network *network)
+void WebApplication::setupSpectator(SpectatorChannel *spectatorChannel)
+{
+    // Frames are pushed from the channel thread
+    enableUpdates(true);
+    SpectatorFrame snapshot;
+    _spectatorSubscription = spectatorChannel->subscribe(sessionId(), [this] (const SpectatorFrame &frame) {
+        showSpectatorFrame(frame);
+        triggerUpdate();
+    }, snapshot);
+    _spectatorChannel = spectatorChannel;
+    _gameController = nullptr;
+    showSpectatorFrame(snapshot);
+}
+
+void WebApplication::showSpectatorFrame(const SpectatorFrame &frame)
+{
+    _gameWidget->boardWidget()->showBoard(frame.board);
+    _gameWidget->headerWidget()->setScore(frame.score);
+}
+
+void WebApplication::setupNeuralNetworkGameController(const BoardEvaluator *evaluator, InferenceService *inferenceService,
+                                                      std::unique_ptr<ExpectimaxSearch> search, TimerWheel *scheduler)
 {
     bool autoRestart = false;
     auto param = environment().getParameter(RestartParameterName);
     if (param && *param == AutoRestartValue)
         autoRestart = true;
-    auto controller = this->addChild(std::make_unique<NeuralNetworkGameController>(_gameCore.get(), network, autoRestart));
+    // Moves scheduled or evaluated by the shared services are delivered with server push
+    if (inferenceService || scheduler)
+        enableUpdates(true);
+    auto controller = this->addChild(std::make_unique<NeuralNetworkGameController>(_gameCore.get(), evaluator, inferenceService,
+                                                                                   std::move(search), autoRestart,
+                                                                                   scheduler, moveDelay()));
     _gameController = controller;
     controller->start();
 }
 
+std::chrono::milliseconds WebApplication::moveDelay()
+{
+    auto param = environment().getParameter(MoveDelayParameterName);
+    if (!param)
+        return std::chrono::milliseconds(DefaultMoveDelay);
+    else if (*param == FastForwardValue)
+        return std::chrono::milliseconds(0);
+    try
+    {
+        return std::chrono::milliseconds(std::stoul(*param));
+    }
+    catch (std::exception &exception)
+    {
+        LOG_WARNING << "WebApplication::moveDelay() - invalid delay " << *param;
+    }
+    return std::chrono::milliseconds(DefaultMoveDelay);
+}
+
 void WebApplication::showInitialTiles() const
 {
     std::vector<TilePosition> positions;
@@ -110,7 +222,18 @@ void WebApplication::serializeReplayMemory() const
 {
     if (_gameCore->state().score < _highscoreThreshold)
     {
-        _gameStateTracker->reset();
+        if (_gameStateTracker)
+            _gameStateTracker->reset();
+        _replayMemoryTracker->reset();
+        return;
+    }
+    if (_replayRecorder)
+    {
+        // Recorder thread compresses and writes the game, session goes on
+        if (!_replayRecorder->submit(_replayMemoryTracker->records()))
+            LOG_WARNING << "Replay recorder queue full, game dropped";
+        if (_gameStateTracker)
+            _gameStateTracker->reset();
         _replayMemoryTracker->reset();
         return;
     }
@@ -119,7 +242,8 @@ void WebApplication::serializeReplayMemory() const
     fileName += dateTime.toString("yyyy-MM-dd HH.mm.ss.zzz", true).toUTF8();
     fileName += ".json";
     _replayMemoryTracker->serializeReplayMemory(fileName);
-    _gameStateTracker->reset();
+    if (_gameStateTracker)
+        _gameStateTracker->reset();
     _replayMemoryTracker->reset();
 }
 
@@ -150,7 +274,7 @@ unsigned int WebApplication::getBestScoreCookie()
         }
         catch (std::exception exception)
         {
-            std::cerr << "BastardApplication::getBestScoreCookie() - exception caught: " << exception.what() << std::endl;
+            LOG_WARNING << "BastardApplication::getBestScoreCookie() - exception caught: " << exception.what();
         }
     }
     return score;
@@ -4,9 +4,15 @@
 #include <Wt/WApplication.h>
 #include <GameCore.h>
 #include <GameStateTracker.h>
-#include <Network.h>
 #include "../utils/Defaults.h"
+#include "../utils/BoardEvaluator.h"
+#include "../utils/ExpectimaxSearch.h"
+#include "../utils/InferenceService.h"
 #include "../utils/ReplayMemoryTracker.h"
+#include "../utils/ReplayRecorder.h"
+#include "../utils/TimerWheel.h"
+#include "../utils/WebAppMetrics.h"
+#include "SpectatorChannel.h"
 
 namespace nn2048
 {
@@ -18,13 +24,31 @@ class WebApplication : public Wt::WApplication
 {
 public:
     WebApplication(const Wt::WEnvironment &env,
-                   const NeuralNetwork::Network *network = nullptr,
-                   unsigned long highscoreThreshold = DefaultHighscoreToRecordThreshold);
+                   const BoardEvaluator *evaluator = nullptr,
+                   InferenceService *inferenceService = nullptr,
+                   const ExpectimaxSettings &searchSettings = ExpectimaxSettings(),
+                   unsigned long highscoreThreshold = DefaultHighscoreToRecordThreshold,
+                   ReplayRecorder *replayRecorder = nullptr,
+                   SpectatorChannel *spectatorChannel = nullptr,
+                   TimerWheel *scheduler = nullptr,
+                   WebAppMetrics *metrics = nullptr);
+    ~WebApplication();
+
+    /// Load tests drive sessions without a browser, the caller holds the update lock
+    PackedBoard board() const;
+    /// Applies the move like a player would and starts a new game when the game is over
+    bool playMove(Game2048Core::Direction direction);
 
 protected:
-    void setupGameController(const NeuralNetwork::Network *network);
+    void setupGameController(const BoardEvaluator *evaluator, InferenceService *inferenceService,
+                             const ExpectimaxSettings &searchSettings, SpectatorChannel *spectatorChannel,
+                             TimerWheel *scheduler);
     void setupKeyboardGameController();
-    void setupNeuralNetworkGameController(const NeuralNetwork::Network *network);
+    void setupSpectator(SpectatorChannel *spectatorChannel);
+    void showSpectatorFrame(const SpectatorFrame &frame);
+    void setupNeuralNetworkGameController(const BoardEvaluator *evaluator, InferenceService *inferenceService,
+                                          std::unique_ptr<ExpectimaxSearch> search, TimerWheel *scheduler);
+    std::chrono::milliseconds moveDelay();
 
     void showInitialTiles() const;
     void serializeReplayMemory() const;
@@ -35,6 +59,11 @@ protected:
 
 private:
     unsigned long _highscoreThreshold;
+    ReplayRecorder *_replayRecorder;
+    SpectatorChannel *_spectatorChannel;
+    unsigned long _spectatorSubscription;
+    WebAppMetrics *_metrics;
+    WebAppMetrics::SessionType _sessionType;
     std::unique_ptr<Game2048Core::GameCore> _gameCore;
     std::unique_ptr<Game2048Core::GameStateTracker> _gameStateTracker;
     std::unique_ptr<ReplayMemoryTracker> _replayMemoryTracker;